@@ -30,7 +30,7 @@ exports.handler = async (event, context) => {
 
   try {
     // Extract parameters
-    const { endpoint, token: tokenFromQuery, start_date, end_date } = event.queryStringParameters || {};
+    const { endpoint, token: tokenFromQuery, start_date, end_date, start_datetime, end_datetime } = event.queryStringParameters || {};
 
     // Prefer Authorization header if present; fallback to token query param
     const authHeader = (event.headers && (event.headers.Authorization || event.headers.authorization)) || '';
@@ -52,6 +52,7 @@ exports.handler = async (event, context) => {
       'heartrate',
       'daily_readiness', 
       'daily_sleep',
+      'sleep',
       'daily_activity',
       'daily_stress',
       'personal_info'
@@ -72,6 +73,7 @@ exports.handler = async (event, context) => {
       'heartrate': 'https://api.ouraring.com/v2/usercollection/heartrate',
       'daily_readiness': 'https://api.ouraring.com/v2/usercollection/daily_readiness',
       'daily_sleep': 'https://api.ouraring.com/v2/usercollection/daily_sleep',
+      'sleep': 'https://api.ouraring.com/v2/usercollection/sleep',
       'daily_activity': 'https://api.ouraring.com/v2/usercollection/daily_activity',
       'daily_stress': 'https://api.ouraring.com/v2/usercollection/daily_stress',
       'personal_info': 'https://api.ouraring.com/v2/usercollection/personal_info'
@@ -83,6 +85,9 @@ exports.handler = async (event, context) => {
     const params = new URLSearchParams();
     if (start_date) params.append('start_date', start_date);
     if (end_date) params.append('end_date', end_date);
+    // heartrate is a time series and takes a datetime window instead
+    if (start_datetime) params.append('start_datetime', start_datetime);
+    if (end_datetime) params.append('end_datetime', end_datetime);
     
     if (params.toString()) {
       ouraUrl += '?' + params.toString();
@@ -12,24 +12,16 @@
 // Main window and layers
 static Window *s_window;
 static TextLayer *s_time_layer;
+static TextLayer *s_seconds_layer;     // Small seconds region beside the time
 static TextLayer *s_date_layer;
-static TextLayer *s_debug_layer;
-static TextLayer *s_sample_indicator_layer;
-static TextLayer *s_heart_rate_layer;
-static TextLayer *s_heart_rate_label_layer;
-static TextLayer *s_readiness_layer;
-static TextLayer *s_readiness_label_layer;
-static TextLayer *s_sleep_layer;
-static TextLayer *s_sleep_label_layer;
-static TextLayer *s_activity_layer;
-static TextLayer *s_activity_label_layer;
-static TextLayer *s_stress_layer;
-static TextLayer *s_stress_label_layer;
-static Layer *s_loading_layer;
-static TextLayer *s_loading_text_layer; // Big bold header at top
-static TextLayer *s_loading_logs_layer; // Multi-line logs underneath
-
-// Persistent storage keys
+static Layer *s_metrics_layer;          // Custom-drawn grid for all metric cells
+// Optional layers: created on demand and destroyed again once unused
+static TextLayer *s_sample_indicator_layer; // Only while there is indicator text
+static Layer *s_loading_layer;              // Only while the loading overlay is up
+static TextLayer *s_loading_text_layer;     // Big bold header at top
+static TextLayer *s_loading_logs_layer;     // Multi-line logs underneath (debug only)
+
+// Legacy per-key persistent storage (migrated into the settings blob, see SETTINGS STORAGE)
 #define PERSIST_KEY_SHOW_DEBUG          1001
 #define PERSIST_KEY_REFRESH_FREQUENCY   1002
 #define PERSIST_KEY_SHOW_LOADING        1003
@@ -50,13 +42,73 @@ static TextLayer *s_loading_logs_layer; // Multi-line logs underneath
 
 // Data buffers
 static char s_time_buffer[16];
+static char s_seconds_buffer[4];
 static char s_date_buffer[32]; // Increased for long date formats like "Sunday, August 6"
 static char s_sample_indicator_buffer[16];
-static char s_heart_rate_buffer[16];
-static char s_readiness_buffer[16];
-static char s_sleep_buffer[16];
-static char s_activity_buffer[16];
-static char s_stress_buffer[16];
+
+// Metrics grid: one cell per layout position, drawn by s_metrics_layer.
+// Positions 0-2 are row 1 (left, middle, right), 3-4 are row 2 (left, right).
+#define METRIC_CELL_COUNT 5
+
+typedef struct {
+  GRect value_frame;      // value text rect (window coordinates)
+  GRect label_frame;      // label/emoji rect (window coordinates)
+  GFont value_font;       // chosen by fit_metric_cell_font()
+  GFont label_font;
+  GColor color;
+  int8_t measurement;     // measurement type shown here, -1 if unassigned
+  bool hidden;
+  bool stale;             // source overdue: draw the stale marker
+  bool local;             // value read from the watch sensors: draw the local marker
+  int8_t trend;           // -1/0/+1 against the recent history (see METRIC HISTORY)
+  const char *label;      // static string (text label or emoji)
+  char value[16];
+} MetricCell;
+
+static MetricCell s_metric_cells[METRIC_CELL_COUNT];
+static uint8_t s_metric_dirty_mask = 0; // bit per cell that needs re-fitting before the next draw
+
+// Per-measurement formatted text, rebuilt only when that measurement changes.
+// Measurement types are METRIC REGISTRY ids.
+#define MEASUREMENT_TYPE_COUNT 12
+static char s_measurement_text[MEASUREMENT_TYPE_COUNT][16];
+
+// Configurable metric colors; every registry entry follows one of these
+#define METRIC_COLOR_READINESS   0
+#define METRIC_COLOR_SLEEP       1
+#define METRIC_COLOR_HEART_RATE  2
+#define METRIC_COLOR_ACTIVITY    3
+#define METRIC_COLOR_STRESS      4
+#define METRIC_COLOR_SLOT_COUNT  5
+
+// Oura endpoints the metrics come from; bit n of the packet availability and
+// request stale masks (see METRIC FRESHNESS)
+#define METRIC_SOURCE_HEART_RATE  0
+#define METRIC_SOURCE_READINESS   1
+#define METRIC_SOURCE_SLEEP       2
+#define METRIC_SOURCE_ACTIVITY    3
+#define METRIC_SOURCE_STRESS      4
+#define METRIC_SOURCE_COUNT       5
+#define METRIC_SOURCE_ALL         ((1 << METRIC_SOURCE_COUNT) - 1)
+
+// Render scheduler state (see RENDER SCHEDULER)
+#define RENDER_DIRTY_METRICS  (1 << 0)  // measurement values, labels or assignment changed
+#define RENDER_DIRTY_LAYOUT   (1 << 1)  // row count / cell geometry changed
+#define RENDER_DIRTY_THEME    (1 << 2)  // colors changed
+static uint8_t s_render_dirty = 0;
+static uint16_t s_measurement_dirty = (1 << MEASUREMENT_TYPE_COUNT) - 1;
+static AppTimer *s_render_timer = NULL;
+
+// Counters to confirm one render pass per message
+typedef struct {
+  uint32_t messages;      // inbox messages received
+  uint32_t requests;      // request_render() calls
+  uint32_t passes;        // render passes actually run
+  uint32_t formats;       // measurement strings rebuilt
+  uint32_t cell_updates;  // cells whose visible content changed
+  uint32_t text_measures; // graphics_text_layout_get_content_size() calls
+} RenderStats;
+static RenderStats s_render_stats;
 
 // Timer for debug message timeout
 static AppTimer *s_debug_timer = NULL;
@@ -74,7 +126,8 @@ static bool s_show_seconds = false;          // Show seconds in time display
 static bool s_compact_time = false;          // Compact time format (trim leading zero in 12h)
 
 // Measurement layout configuration
-// 0=readiness, 1=sleep, 2=heart_rate, 3=activity, 4=stress
+// Values are METRIC REGISTRY ids: 0=readiness, 1=sleep, 2=heart_rate, 3=activity, 4=stress,
+// 5=hrv, 6=temperature deviation, 7=recovery index, 8=total sleep, 9=deep sleep, 10=steps, 11=active calories
 static int s_layout_left = 0;    // Default: readiness
 static int s_layout_middle = 1;  // Default: sleep
 static int s_layout_right = 2;   // Default: heart_rate
@@ -84,6 +137,7 @@ static int s_layout_row2_right = 4;  // Default: stress
 
 // Forward declarations
 static void fetch_oura_data(void);
+static void refresh_scheduler_minute_tick(struct tm *tick_time);
 static void click_config_provider(void *context);
 static void select_long_click_handler(ClickRecognizerRef recognizer, void *context);
 
@@ -131,76 +185,14 @@ static void loading_layer_update_proc(Layer *layer, GContext *ctx);
 static void hide_loading_overlay(void);
 static void show_loading_overlay(void);
 
-// Get color from palette by index
+// Palette indexes from the config page are in canonical GColor8 order
+// (2 bits each of R, G, B), so index i is simply the opaque color 0xC0 | i.
+// Negative indexes fall back to black; larger ones wrap like before.
 static GColor get_palette_color(int index) {
-  switch (index % s_color_palette_size) {
-    case 0: return GColorBlack;
-    case 1: return GColorOxfordBlue;
-    case 2: return GColorDukeBlue;
-    case 3: return GColorBlue;
-    case 4: return GColorDarkGreen;
-    case 5: return GColorMidnightGreen;
-    case 6: return GColorCobaltBlue;
-    case 7: return GColorBlueMoon;
-    case 8: return GColorIslamicGreen;
-    case 9: return GColorJaegerGreen;
-    case 10: return GColorTiffanyBlue;
-    case 11: return GColorVividCerulean;
-    case 12: return GColorGreen;
-    case 13: return GColorMalachite;
-    case 14: return GColorMediumSpringGreen;
-    case 15: return GColorCyan;
-    case 16: return GColorBulgarianRose;
-    case 17: return GColorImperialPurple;
-    case 18: return GColorIndigo;
-    case 19: return GColorElectricUltramarine;
-    case 20: return GColorArmyGreen;
-    case 21: return GColorDarkGray;
-    case 22: return GColorLiberty;
-    case 23: return GColorVeryLightBlue;
-    case 24: return GColorKellyGreen;
-    case 25: return GColorMayGreen;
-    case 26: return GColorCadetBlue;
-    case 27: return GColorPictonBlue;
-    case 28: return GColorBrightGreen;
-    case 29: return GColorScreaminGreen;
-    case 30: return GColorMediumAquamarine;
-    case 31: return GColorElectricBlue;
-    case 32: return GColorDarkCandyAppleRed;
-    case 33: return GColorJazzberryJam;
-    case 34: return GColorPurple;
-    case 35: return GColorVividViolet;
-    case 36: return GColorWindsorTan;
-    case 37: return GColorRoseVale;
-    case 38: return GColorPurpureus;
-    case 39: return GColorLavenderIndigo;
-    case 40: return GColorLimerick;
-    case 41: return GColorBrass;
-    case 42: return GColorLightGray;
-    case 43: return GColorBabyBlueEyes;
-    case 44: return GColorSpringBud;
-    case 45: return GColorInchworm;
-    case 46: return GColorMintGreen;
-    case 47: return GColorCeleste;
-    case 48: return GColorRed;
-    case 49: return GColorFolly;
-    case 50: return GColorFashionMagenta;
-    case 51: return GColorMagenta;
-    case 52: return GColorOrange;
-    case 53: return GColorSunsetOrange;
-    case 54: return GColorBrilliantRose;
-    case 55: return GColorShockingPink;
-    case 56: return GColorChromeYellow;
-    case 57: return GColorRajah;
-    case 58: return GColorMelon;
-    case 59: return GColorRichBrilliantLavender;
-    case 60: return GColorYellow;
-    case 61: return GColorIcterine;
-    case 62: return GColorPastelYellow;
-    case 63: return GColorWhite;
-    default: return GColorBlack;
+  if (index < 0) {
+    return GColorBlack;
   }
-  
+  return (GColor){ .argb = (uint8_t)(0xC0 | (index % s_color_palette_size)) };
 }
 
 // Helper to (re)subscribe to tick timer based on show_seconds
@@ -213,28 +205,38 @@ static void update_tick_subscription(void) {
   }
 }
 
-// Smart contrast system - determines if a color is light or dark
+// Smart contrast system - determines if a color is light or dark.
+// Palette entries that need dark text for contrast, one bit per index:
+// White, VeryLightBlue, BabyBlueEyes, LightGray, PastelYellow, Icterine,
+// Yellow, ChromeYellow, Melon, RichBrilliantLavender, Cyan, MintGreen,
+// Celeste, TiffanyBlue, MediumSpringGreen, ScreaminGreen, Inchworm,
+// SpringBud, Limerick
+static const uint64_t k_light_palette_mask = 0xfd00fd002080c400ULL;
+
 static bool is_light_color(GColor color) {
-  // Define light colors that need dark text for contrast
-  return gcolor_equal(color, GColorWhite) ||
-         gcolor_equal(color, GColorVeryLightBlue) ||
-         gcolor_equal(color, GColorBabyBlueEyes) ||
-         gcolor_equal(color, GColorLightGray) ||
-         gcolor_equal(color, GColorPastelYellow) ||
-         gcolor_equal(color, GColorIcterine) ||
-         gcolor_equal(color, GColorYellow) ||
-         gcolor_equal(color, GColorChromeYellow) ||
-         gcolor_equal(color, GColorMelon) ||
-         gcolor_equal(color, GColorRichBrilliantLavender) ||
-         gcolor_equal(color, GColorCyan) ||
-         gcolor_equal(color, GColorMintGreen) ||
-         gcolor_equal(color, GColorCeleste) ||
-         gcolor_equal(color, GColorTiffanyBlue) ||
-         gcolor_equal(color, GColorMediumSpringGreen) ||
-         gcolor_equal(color, GColorScreaminGreen) ||
-         gcolor_equal(color, GColorInchworm) ||
-         gcolor_equal(color, GColorSpringBud) ||
-         gcolor_equal(color, GColorLimerick);
+  return (color.argb & 0xC0) == 0xC0 && ((k_light_palette_mask >> (color.argb & 0x3F)) & 1);
+}
+
+// Theme colors resolved from the palette indexes; rebuilt by resolve_theme()
+// whenever a color setting changes, then applied to the layers in one pass.
+typedef struct {
+  GColor background;
+  GColor time;
+  GColor date;
+  GColor metric[METRIC_COLOR_SLOT_COUNT];  // by METRIC_COLOR_* slot
+} ResolvedTheme;
+
+static ResolvedTheme s_theme;
+
+static void resolve_theme(void) {
+  s_theme.background = get_palette_color(s_background_color);
+  s_theme.time = get_palette_color(s_time_color);
+  s_theme.date = get_palette_color(s_date_color);
+  s_theme.metric[METRIC_COLOR_READINESS] = get_palette_color(s_readiness_color);
+  s_theme.metric[METRIC_COLOR_SLEEP] = get_palette_color(s_sleep_color);
+  s_theme.metric[METRIC_COLOR_HEART_RATE] = get_palette_color(s_heart_rate_color);
+  s_theme.metric[METRIC_COLOR_ACTIVITY] = get_palette_color(s_activity_color);
+  s_theme.metric[METRIC_COLOR_STRESS] = get_palette_color(s_stress_color);
 }
 
 // Helper functions for theme colors
@@ -299,19 +301,682 @@ static OuraSleepData s_sleep_data = {0};
 static OuraActivityData s_activity_data = {0};
 static OuraStressData s_stress_data = {0};
 static bool s_using_sample_data = false;
+static bool s_metrics_stale = false;      // values come from the persisted snapshot, no fresh packet yet
+static time_t s_metrics_received_at = 0;  // watch time the displayed values arrived
+
+// =============================================================================
+// METRIC REGISTRY
+// =============================================================================
+// Every displayable metric is one descriptor. Layout positions (layout_left,
+// row2_right, ...) hold the descriptor id, so adding a metric is a table entry
+// and the config page option with the same value.
+
+typedef enum {
+  METRIC_FORMAT_INT = 0,      // plain integer
+  METRIC_FORMAT_SECONDS_HM,   // seconds as "2h 5m" / "5m"
+  METRIC_FORMAT_MINUTES_HM,   // minutes as "7h 12m" / "45m"
+  METRIC_FORMAT_CENTI_SIGNED  // hundredths as "+0.3" / "-1.2"
+} MetricFormat;
+
+typedef struct {
+  const char *label;          // text label (always used on aplite)
+  const char *emoji;          // NULL falls back to the text label
+  MetricFormat format;
+  uint8_t color_slot;         // METRIC_COLOR_* (configurable color it follows)
+  uint8_t source;             // METRIC_SOURCE_* endpoint that provides it
+  bool zero_is_missing;       // 0 means "not reported" rather than a real value
+  const int *value;           // source field in the Oura structs
+  const bool *available;      // availability flag of that struct
+} MetricDescriptor;
+
+// IMPORTANT: Pebble emoji require Gothic fonts and Unicode escapes (\\UXXXXXXXX)
+static const MetricDescriptor k_metrics[MEASUREMENT_TYPE_COUNT] = {
+  // 0: Readiness - Flexed Biceps U+1F4AA (may be unsupported on some firmwares)
+  { "RDY", "\U0001F4AA", METRIC_FORMAT_INT, METRIC_COLOR_READINESS, METRIC_SOURCE_READINESS, false,
+    &s_readiness_data.readiness_score, &s_readiness_data.data_available },
+  // 1: Sleep - Sleeping Face U+1F634 (supported range)
+  { "SLP", "\U0001F634", METRIC_FORMAT_INT, METRIC_COLOR_SLEEP, METRIC_SOURCE_SLEEP, false,
+    &s_sleep_data.sleep_score, &s_sleep_data.data_available },
+  // 2: Heart Rate - Heart U+2764 (without VS-16)
+  { "HR", "\U00002764", METRIC_FORMAT_INT, METRIC_COLOR_HEART_RATE, METRIC_SOURCE_HEART_RATE, false,
+    &s_heart_rate_data.resting_heart_rate, &s_heart_rate_data.data_available },
+  // 3: Activity - Fire U+1F525
+  { "ACT", "\U0001F525", METRIC_FORMAT_INT, METRIC_COLOR_ACTIVITY, METRIC_SOURCE_ACTIVITY, true,
+    &s_activity_data.activity_score, &s_activity_data.data_available },
+  // 4: Stress - Face with Open Mouth and Cold Sweat U+1F630 (supported range)
+  { "STR", "\U0001F630", METRIC_FORMAT_SECONDS_HM, METRIC_COLOR_STRESS, METRIC_SOURCE_STRESS, false,
+    &s_stress_data.stress_duration, &s_stress_data.data_available },
+  // 5-11: secondary fields already carried in the metrics packet
+  { "HRV", NULL, METRIC_FORMAT_INT, METRIC_COLOR_HEART_RATE, METRIC_SOURCE_HEART_RATE, true,
+    &s_heart_rate_data.hrv_score, &s_heart_rate_data.data_available },
+  { "TMP", NULL, METRIC_FORMAT_CENTI_SIGNED, METRIC_COLOR_READINESS, METRIC_SOURCE_READINESS, false,
+    &s_readiness_data.temperature_deviation, &s_readiness_data.data_available },
+  { "REC", NULL, METRIC_FORMAT_INT, METRIC_COLOR_READINESS, METRIC_SOURCE_READINESS, true,
+    &s_readiness_data.recovery_index, &s_readiness_data.data_available },
+  { "TOT", NULL, METRIC_FORMAT_MINUTES_HM, METRIC_COLOR_SLEEP, METRIC_SOURCE_SLEEP, true,
+    &s_sleep_data.total_sleep_time, &s_sleep_data.data_available },
+  { "DEEP", NULL, METRIC_FORMAT_MINUTES_HM, METRIC_COLOR_SLEEP, METRIC_SOURCE_SLEEP, true,
+    &s_sleep_data.deep_sleep_time, &s_sleep_data.data_available },
+  { "STP", NULL, METRIC_FORMAT_INT, METRIC_COLOR_ACTIVITY, METRIC_SOURCE_ACTIVITY, false,
+    &s_activity_data.steps, &s_activity_data.data_available },
+  { "CAL", NULL, METRIC_FORMAT_INT, METRIC_COLOR_ACTIVITY, METRIC_SOURCE_ACTIVITY, false,
+    &s_activity_data.active_calories, &s_activity_data.data_available },
+};
+
+// Write a non-negative integer, return the end of the digits
+static char *write_uint(char *out, unsigned int value) {
+  char digits[10];
+  int n = 0;
+  do {
+    digits[n++] = (char)('0' + value % 10);
+    value /= 10;
+  } while (value);
+  while (n) {
+    *out++ = digits[--n];
+  }
+  return out;
+}
+
+// Render one value in the descriptor's format (buffer is at least 16 bytes)
+static void format_metric_value(char *out, MetricFormat format, int value) {
+  switch (format) {
+    case METRIC_FORMAT_SECONDS_HM:
+      value /= 60;  // now minutes
+      // fall through
+    case METRIC_FORMAT_MINUTES_HM: {
+      unsigned int minutes = value > 0 ? (unsigned int)value : 0;
+      if (minutes >= 60) {
+        out = write_uint(out, minutes / 60);
+        *out++ = 'h';
+        *out++ = ' ';
+      }
+      out = write_uint(out, minutes % 60);
+      *out++ = 'm';
+      break;
+    }
+    case METRIC_FORMAT_CENTI_SIGNED: {
+      // Round to tenths: 23 -> "+0.2", -27 -> "-0.3"
+      *out++ = value < 0 ? '-' : '+';
+      unsigned int tenths = (unsigned int)((value < 0 ? -value : value) + 5) / 10;
+      out = write_uint(out, tenths / 10);
+      *out++ = '.';
+      *out++ = (char)('0' + tenths % 10);
+      break;
+    }
+    case METRIC_FORMAT_INT:
+    default:
+      if (value < 0) {
+        *out++ = '-';
+        value = -value;
+      }
+      out = write_uint(out, (unsigned int)value);
+      break;
+  }
+  *out = '\0';
+}
+
+// =============================================================================
+// METRIC FRESHNESS
+// =============================================================================
+// Each Oura endpoint (METRIC_SOURCE_*) is tracked on its own: when the phone
+// last fetched it and which day that fetch was for. Requests only ask for the
+// stale sources, and cells whose source is overdue get a small marker.
+// Readiness and sleep are daily scores that settle once synced, activity and
+// stress accumulate through the day, heart rate moves all the time.
+
+#define STALE_DISPLAY_GRACE_MIN  120   // overdue this long before cells are marked
+
+static const uint16_t k_source_max_age_min[METRIC_SOURCE_COUNT] = {
+  [METRIC_SOURCE_HEART_RATE] = 0,      // every refresh
+  [METRIC_SOURCE_READINESS]  = 360,
+  [METRIC_SOURCE_SLEEP]      = 360,
+  [METRIC_SOURCE_ACTIVITY]   = 60,
+  [METRIC_SOURCE_STRESS]     = 60,
+};
+
+static const bool *const k_source_available[METRIC_SOURCE_COUNT] = {
+  [METRIC_SOURCE_HEART_RATE] = &s_heart_rate_data.data_available,
+  [METRIC_SOURCE_READINESS]  = &s_readiness_data.data_available,
+  [METRIC_SOURCE_SLEEP]      = &s_sleep_data.data_available,
+  [METRIC_SOURCE_ACTIVITY]   = &s_activity_data.data_available,
+  [METRIC_SOURCE_STRESS]     = &s_stress_data.data_available,
+};
+
+static uint32_t s_source_updated_at[METRIC_SOURCE_COUNT]; // watch time of the last fetch, 0 = never
+static uint32_t s_source_data_date[METRIC_SOURCE_COUNT];  // YYYYMMDD that fetch was for
+static uint8_t s_stale_display_sources = 0;               // sources currently marked on screen
+
+static void mark_measurement_dirty(int measurement_type);
+static uint16_t source_max_age_minutes(int source);
+
+static uint32_t date_yyyymmdd(time_t t) {
+  struct tm *tm = localtime(&t);
+  return (uint32_t)((tm->tm_year + 1900) * 10000 + (tm->tm_mon + 1) * 100 + tm->tm_mday);
+}
+
+static uint32_t source_age_minutes(int source, time_t now) {
+  // A clock set backwards makes the age huge, which just means "refetch"
+  return (uint32_t)(now - (time_t)s_source_updated_at[source]) / 60;
+}
+
+// Sources to ask the phone for: never fetched, not fetched today, still
+// without data, or older than their max age
+static uint8_t metric_sources_to_fetch(time_t now) {
+  uint32_t today = date_yyyymmdd(now);
+  uint8_t mask = 0;
+  for (int source = 0; source < METRIC_SOURCE_COUNT; source++) {
+    if (!s_source_updated_at[source] || s_source_data_date[source] != today ||
+        !*k_source_available[source] ||
+        source_age_minutes(source, now) >= source_max_age_minutes(source)) {
+      mask |= (uint8_t)(1 << source);
+    }
+  }
+  return mask;
+}
+
+// Sources whose shown values are from an earlier day or overdue past the grace period
+static uint8_t metric_sources_overdue(time_t now) {
+  if (s_using_sample_data) {
+    return 0;
+  }
+  uint32_t today = date_yyyymmdd(now);
+  uint8_t mask = 0;
+  for (int source = 0; source < METRIC_SOURCE_COUNT; source++) {
+    if (!s_source_updated_at[source]) {
+      continue; // nothing shown from it yet
+    }
+    if (s_source_data_date[source] != today ||
+        source_age_minutes(source, now) > (uint32_t)k_source_max_age_min[source] + STALE_DISPLAY_GRACE_MIN) {
+      mask |= (uint8_t)(1 << source);
+    }
+  }
+  return mask;
+}
+
+// Re-evaluate the per-cell markers; redraws only measurements whose source flipped
+static void update_stale_indicators(time_t now) {
+  uint8_t overdue = metric_sources_overdue(now);
+  uint8_t changed = overdue ^ s_stale_display_sources;
+  if (!changed) {
+    return;
+  }
+  s_stale_display_sources = overdue;
+  for (int i = 0; i < MEASUREMENT_TYPE_COUNT; i++) {
+    if (changed & (1 << k_metrics[i].source)) {
+      mark_measurement_dirty(i);
+    }
+  }
+}
+
+static bool measurement_is_stale(int measurement_type) {
+  return measurement_type >= 0 && measurement_type < MEASUREMENT_TYPE_COUNT &&
+         (s_stale_display_sources & (1 << k_metrics[measurement_type].source)) &&
+         *k_metrics[measurement_type].available;
+}
+
+// =============================================================================
+// METRIC HISTORY
+// =============================================================================
+// 30 days of the headline scores kept on the watch, so trends need no phone
+// round trip. Each series stores its latest value plus one signed byte per
+// day: the change from the previous day that had a value. Slots form a ring
+// indexed by day number, so a new day overwrites the oldest one in place.
+// All series share one persist record well under the 256-byte limit.
+
+#define PERSIST_KEY_METRIC_HISTORY  3002
+#define HISTORY_VERSION             2         // 2: heart rate series dropped
+#define HISTORY_DAYS                30
+#define HISTORY_MISSING             INT8_MIN  // no value that day
+#define HISTORY_TREND_DAYS          7         // baseline for the trend arrow
+#define HISTORY_TREND_THRESHOLD     3         // points away from the baseline to show an arrow
+
+// Measurement ids (METRIC REGISTRY) that keep a history. Heart rate is the
+// latest sample, not a daily value, so it has no series.
+static const int8_t k_history_metrics[] = { 0, 1, 3 };  // RDY, SLP, ACT
+#define HISTORY_SERIES_COUNT  ((int)(sizeof(k_history_metrics) / sizeof(k_history_metrics[0])))
+
+typedef struct __attribute__((__packed__)) {
+  int16_t latest;               // value on last_day
+  int8_t delta[HISTORY_DAYS];   // by day % HISTORY_DAYS; HISTORY_MISSING if absent
+} HistorySeries;
+
+typedef struct __attribute__((__packed__)) {
+  uint8_t version;
+  uint16_t last_day;            // day number (days since 1970-01-01, local date) of the newest slot
+  HistorySeries series[HISTORY_SERIES_COUNT];
+} MetricHistory;
+
+static MetricHistory s_history;
+
+// Day number of a YYYYMMDD date (days since 1970-01-01, proleptic Gregorian)
+static uint16_t history_day_from_date(uint32_t yyyymmdd) {
+  int y = (int)(yyyymmdd / 10000);
+  int m = (int)(yyyymmdd / 100 % 100);
+  int d = (int)(yyyymmdd % 100);
+  y -= m <= 2;
+  int era = y / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return (uint16_t)(era * 146097 + doe - 719468);
+}
+
+static int8_t history_clamp_delta(int delta) {
+  // Scores move far less than this per day; clamping only guards the encoding
+  return (int8_t)(delta > INT8_MAX ? INT8_MAX : (delta <= HISTORY_MISSING ? HISTORY_MISSING + 1 : delta));
+}
+
+static void history_reset(void) {
+  memset(&s_history, 0, sizeof(s_history));
+  s_history.version = HISTORY_VERSION;
+  for (int i = 0; i < HISTORY_SERIES_COUNT; i++) {
+    memset(s_history.series[i].delta, (uint8_t)HISTORY_MISSING, HISTORY_DAYS);
+  }
+}
+
+static void load_metric_history(void) {
+  int read = persist_read_data(PERSIST_KEY_METRIC_HISTORY, &s_history, sizeof(s_history));
+  if (read != (int)sizeof(s_history) || s_history.version != HISTORY_VERSION) {
+    history_reset();
+  }
+}
+
+static bool history_has_day(const HistorySeries *series, uint16_t day) {
+  return s_history.last_day && series->delta[day % HISTORY_DAYS] != HISTORY_MISSING;
+}
+
+// Record one value for a day; returns whether the stored history changed
+static bool history_record(HistorySeries *series, uint16_t day, int value) {
+  int8_t *slot = &series->delta[day % HISTORY_DAYS];
+  if (day == s_history.last_day && *slot != HISTORY_MISSING) {
+    // Same day again (activity moves during the day)
+    if (value == series->latest) {
+      return false;
+    }
+    *slot = history_clamp_delta(*slot + (value - series->latest));
+    series->latest = (int16_t)value;
+    return true;
+  }
+  // Find the value this day's delta is relative to: the newest earlier day with one
+  int previous = value;
+  for (int age = 0; age < HISTORY_DAYS; age++) {
+    if (history_has_day(series, (uint16_t)(s_history.last_day - age))) {
+      previous = series->latest;
+      break;
+    }
+  }
+  *slot = history_clamp_delta(value - previous);
+  series->latest = (int16_t)value;
+  return true;
+}
+
+// Advance the ring to `day`, blanking the slots of skipped days in every series
+static bool history_advance(uint16_t day) {
+  if (s_history.last_day && day <= s_history.last_day) {
+    return false;
+  }
+  uint16_t gap = s_history.last_day ? (uint16_t)(day - s_history.last_day) : HISTORY_DAYS;
+  if (gap > HISTORY_DAYS) {
+    gap = HISTORY_DAYS;
+  }
+  for (int i = 0; i < HISTORY_SERIES_COUNT; i++) {
+    for (uint16_t n = 0; n < gap; n++) {
+      s_history.series[i].delta[(day - n) % HISTORY_DAYS] = HISTORY_MISSING;
+    }
+  }
+  return true;
+}
+
+// Fold the current values of the fetched sources into the history
+static void update_metric_history(uint32_t data_date, uint8_t fetched) {
+  if (!data_date || s_using_sample_data) {
+    return;
+  }
+  uint16_t day = history_day_from_date(data_date);
+  if (s_history.last_day && day < s_history.last_day) {
+    return; // older than what we have (clock moved back)
+  }
+  bool changed = false;
+  bool new_day = day != s_history.last_day;
+  for (int i = 0; i < HISTORY_SERIES_COUNT; i++) {
+    const MetricDescriptor *metric = &k_metrics[k_history_metrics[i]];
+    int value = *metric->value;
+    if (!(fetched & (1 << metric->source)) || !*metric->available ||
+        (metric->zero_is_missing && value == 0)) {
+      continue;
+    }
+    if (new_day && !changed) {
+      // First value of a new day: blank the skipped days before writing it
+      history_advance(day);
+      changed = true;
+    }
+    changed |= history_record(&s_history.series[i], day, value);
+  }
+  if (new_day && changed) {
+    s_history.last_day = day;
+  }
+  if (changed) {
+    persist_write_data(PERSIST_KEY_METRIC_HISTORY, &s_history, sizeof(s_history));
+  }
+}
+
+// Decode a series newest first into out[age]; returns the number of days with a value
+static int history_decode(int series_index, int16_t out[HISTORY_DAYS], bool present[HISTORY_DAYS]) {
+  const HistorySeries *series = &s_history.series[series_index];
+  int count = 0;
+  int value = series->latest;
+  int pending = 0;      // delta that leads from the previous present day to `value`
+  bool first = true;
+  for (int age = 0; age < HISTORY_DAYS; age++) {
+    int8_t delta = series->delta[(uint16_t)(s_history.last_day - age) % HISTORY_DAYS];
+    present[age] = s_history.last_day && delta != HISTORY_MISSING;
+    if (!present[age]) {
+      continue;
+    }
+    if (!first) {
+      value -= pending;
+    }
+    first = false;
+    pending = delta;
+    out[age] = (int16_t)value;
+    count++;
+  }
+  return count;
+}
+
+static int history_series_for(int measurement_type) {
+  for (int i = 0; i < HISTORY_SERIES_COUNT; i++) {
+    if (k_history_metrics[i] == measurement_type) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// -1, 0 or +1: latest value against the mean of the previous HISTORY_TREND_DAYS days
+static int8_t history_trend(int measurement_type) {
+  int series_index = history_series_for(measurement_type);
+  if (series_index < 0 || !s_history.last_day) {
+    return 0;
+  }
+  int16_t values[HISTORY_DAYS];
+  bool present[HISTORY_DAYS];
+  if (history_decode(series_index, values, present) < 2 || !present[0]) {
+    return 0;
+  }
+  int sum = 0, n = 0;
+  for (int age = 1; age <= HISTORY_TREND_DAYS; age++) {
+    if (present[age]) {
+      sum += values[age];
+      n++;
+    }
+  }
+  if (!n) {
+    return 0;
+  }
+  int diff = values[0] * n - sum;   // (latest - mean) * n
+  if (diff >= HISTORY_TREND_THRESHOLD * n) return 1;
+  if (diff <= -HISTORY_TREND_THRESHOLD * n) return -1;
+  return 0;
+}
+
+// =============================================================================
+// LOCAL HEALTH (watch sensors)
+// =============================================================================
+// On health-capable watches, steps and current heart rate are also read from
+// HealthService. A local reading stands in for the phone value whenever that
+// is missing or overdue (see METRIC FRESHNESS), so these cells keep moving
+// with Bluetooth off; such cells carry a ring marker instead of the stale dot.
+// While the watch has its own heart rate, requests ask for it less often.
+
+#define MEASUREMENT_HEART_RATE       2    // METRIC REGISTRY ids the sensors can feed
+#define MEASUREMENT_STEPS            10
+#define LOCAL_COVERED_MAX_AGE_MIN    60   // phone heart rate max age while the watch has its own
+
+static uint16_t s_measurement_local_mask = 0;  // measurements currently shown from the watch sensors
+
+#if defined(PBL_HEALTH)
+static int s_local_steps = -1;       // -1 = no reading
+static int s_local_heart_rate = -1;
+
+static int read_local_metric(HealthMetric metric, bool sum_today) {
+  time_t now = time(NULL);
+  time_t start = sum_today ? time_start_of_today() : now;
+  if (!(health_service_metric_accessible(metric, start, now) & HealthServiceAccessibilityMaskAvailable)) {
+    return -1;
+  }
+  return (int)(sum_today ? health_service_sum_today(metric) : health_service_peek_current_value(metric));
+}
+
+static void local_health_refresh(void) {
+  int steps = read_local_metric(HealthMetricStepCount, true);
+  if (steps != s_local_steps) {
+    s_local_steps = steps;
+    mark_measurement_dirty(MEASUREMENT_STEPS);
+  }
+#if PBL_API_EXISTS(health_service_peek_current_value)
+  int heart_rate = read_local_metric(HealthMetricHeartRateBPM, false);
+  if (heart_rate <= 0) {
+    heart_rate = -1;  // no HRM, or not worn
+  }
+  if (heart_rate != s_local_heart_rate) {
+    s_local_heart_rate = heart_rate;
+    mark_measurement_dirty(MEASUREMENT_HEART_RATE);
+  }
+#endif
+}
+
+static void local_health_handler(HealthEventType event, void *context) {
+  if (event != HealthEventSleepUpdate) {
+    local_health_refresh();
+  }
+}
+#endif
+
+static void local_health_init(void) {
+#if defined(PBL_HEALTH)
+  if (health_service_events_subscribe(local_health_handler, NULL)) {
+    local_health_refresh();
+  } else {
+    APP_LOG(APP_LOG_LEVEL_INFO, "HealthService unavailable, phone data only");
+  }
+#endif
+}
+
+static void local_health_deinit(void) {
+#if defined(PBL_HEALTH)
+  health_service_events_unsubscribe();
+#endif
+}
+
+// Sensor reading to show instead of the phone value, if the phone's is missing or overdue
+static bool local_health_value(int measurement_type, int *value) {
+#if defined(PBL_HEALTH)
+  int local = measurement_type == MEASUREMENT_STEPS ? s_local_steps :
+              measurement_type == MEASUREMENT_HEART_RATE ? s_local_heart_rate : -1;
+  if (local < 0 || s_using_sample_data) {
+    return false;
+  }
+  const MetricDescriptor *metric = &k_metrics[measurement_type];
+  bool phone_current = *metric->available && !(metric->zero_is_missing && *metric->value == 0) &&
+                       !(s_stale_display_sources & (1 << metric->source));
+  if (phone_current) {
+    return false;
+  }
+  *value = local;
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Max age for a source's phone fetch, relaxed where the watch measures it itself
+static uint16_t source_max_age_minutes(int source) {
+#if defined(PBL_HEALTH)
+  if (source == METRIC_SOURCE_HEART_RATE && s_local_heart_rate > 0 &&
+      k_source_max_age_min[source] < LOCAL_COVERED_MAX_AGE_MIN) {
+    return LOCAL_COVERED_MAX_AGE_MIN;
+  }
+#endif
+  return k_source_max_age_min[source];
+}
+
+// =============================================================================
+// FONT FIT CACHE
+// =============================================================================
+// Measuring text is the most expensive text work on the watch, so the result
+// of "largest candidate font that fits" is memoized per (text, box, candidates).
+
+typedef struct {
+  const char **font_keys;       // candidate fonts, largest first
+  uint8_t num_fonts;
+  uint8_t padding_w;            // horizontal padding inside the box
+  GTextOverflowMode overflow;
+} FontFitSpec;
+
+typedef struct {
+  uint32_t text_hash;
+  const FontFitSpec *spec;
+  GSize box;
+  uint8_t font_index;
+  bool used;
+} FontFitEntry;
+
+#define FONT_FIT_CACHE_SIZE 12
+static FontFitEntry s_font_fit_cache[FONT_FIT_CACHE_SIZE];
+static uint8_t s_font_fit_next = 0; // round-robin replacement slot
+
+static const char *k_metric_font_keys[] = {
+  FONT_KEY_GOTHIC_24_BOLD,
+  FONT_KEY_GOTHIC_18_BOLD,
+  FONT_KEY_GOTHIC_14
+};
+static const FontFitSpec k_metric_font_spec = {
+  k_metric_font_keys, 3, 2 /* tighter than date */, GTextOverflowModeFill
+};
+
+static const char *k_date_font_keys[] = {
+  FONT_KEY_GOTHIC_28_BOLD,
+  FONT_KEY_GOTHIC_24_BOLD,
+  FONT_KEY_GOTHIC_18_BOLD,
+  FONT_KEY_GOTHIC_14
+};
+static const FontFitSpec k_date_font_spec = {
+  // Slight horizontal padding to avoid edge clipping
+  k_date_font_keys, 4, 6, GTextOverflowModeWordWrap
+};
+
+// FNV-1a hash of a NUL-terminated string
+static uint32_t hash_text(const char *text) {
+  uint32_t hash = 2166136261u;
+  while (*text) {
+    hash ^= (uint8_t)*text++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+// Return the largest font from spec that fits text inside box (smallest if none fit)
+static GFont fit_text_font(const char *text, GSize box, const FontFitSpec *spec) {
+  uint32_t text_hash = hash_text(text);
+  for (int i = 0; i < FONT_FIT_CACHE_SIZE; i++) {
+    FontFitEntry *e = &s_font_fit_cache[i];
+    if (e->used && e->text_hash == text_hash && e->spec == spec &&
+        e->box.w == box.w && e->box.h == box.h) {
+      return fonts_get_system_font(spec->font_keys[e->font_index]);
+    }
+  }
+  
+  GRect test_bounds = GRect(spec->padding_w, 0, box.w - 2 * spec->padding_w, box.h);
+  uint8_t chosen = spec->num_fonts - 1; // If none fit, use the smallest font
+  for (uint8_t i = 0; i < spec->num_fonts; i++) {
+    GSize size = graphics_text_layout_get_content_size(
+        text,
+        fonts_get_system_font(spec->font_keys[i]),
+        test_bounds,
+        spec->overflow,
+        GTextAlignmentCenter);
+    s_render_stats.text_measures++;
+    if (size.w <= test_bounds.size.w && size.h <= test_bounds.size.h) {
+      chosen = i;
+      break;
+    }
+  }
+  
+  FontFitEntry *slot = &s_font_fit_cache[s_font_fit_next];
+  s_font_fit_next = (uint8_t)((s_font_fit_next + 1) % FONT_FIT_CACHE_SIZE);
+  *slot = (FontFitEntry) {
+    .text_hash = text_hash,
+    .spec = spec,
+    .box = box,
+    .font_index = chosen,
+    .used = true
+  };
+  return fonts_get_system_font(spec->font_keys[chosen]);
+}
 
 // =============================================================================
 // TIME MODULE
 // =============================================================================
 
-static void update_time_display() {
-  time_t temp = time(NULL);
-  struct tm *tick_time = localtime(&temp);
+// Clock geometry: the time layer's full-width slot and the fonts chosen by the layout
+static GRect s_clock_frame;
+static GFont s_time_font;
+static GFont s_seconds_font;
+static int16_t s_seconds_offset_y = 0;  // seconds drop inside the clock slot to share the baseline
+static int16_t s_time_width = -1;       // measured HH:MM width the current layout was built for
+
+static void layout_clock_layers(void);
+
+// Set the time/seconds fonts for the current row mode
+static void set_clock_fonts(const char *time_font_key, const char *seconds_font_key, int16_t seconds_offset_y) {
+  s_time_font = fonts_get_system_font(time_font_key);
+  s_seconds_font = fonts_get_system_font(seconds_font_key);
+  s_seconds_offset_y = seconds_offset_y;
+  if (s_time_layer) text_layer_set_font(s_time_layer, s_time_font);
+  if (s_seconds_layer) text_layer_set_font(s_seconds_layer, s_seconds_font);
+  s_time_width = -1;
+  layout_clock_layers();
+}
+
+
+// Position the HH:MM and seconds layers. Seconds live in their own small
+// region to the right of HH:MM, so a seconds tick only touches those glyphs.
+static void layout_clock_layers(void) {
+  if (!s_time_layer || !s_seconds_layer) return;
+  
+  if (!s_show_seconds) {
+    layer_set_frame(text_layer_get_layer(s_time_layer), s_clock_frame);
+    layer_set_hidden(text_layer_get_layer(s_seconds_layer), true);
+    return;
+  }
+  
+  GSize time_size = graphics_text_layout_get_content_size(
+      s_time_buffer, s_time_font, s_clock_frame,
+      GTextOverflowModeWordWrap, GTextAlignmentCenter);
+  GSize seconds_size = graphics_text_layout_get_content_size(
+      "00", s_seconds_font, s_clock_frame,
+      GTextOverflowModeWordWrap, GTextAlignmentLeft);
+  s_render_stats.text_measures += 2;
+  
+  const int gap = 2;
+  int total_w = time_size.w + gap + seconds_size.w;
+  int x = s_clock_frame.origin.x + (s_clock_frame.size.w - total_w) / 2;
+  if (x < 0) x = 0;
+  
+  // Digits of the large time font sit low in its box; drop the seconds to share the baseline
+  int seconds_y = s_clock_frame.origin.y + s_seconds_offset_y;
+  layer_set_frame(text_layer_get_layer(s_time_layer),
+                  GRect(x, s_clock_frame.origin.y, time_size.w + gap, s_clock_frame.size.h));
+  layer_set_frame(text_layer_get_layer(s_seconds_layer),
+                  GRect(x + time_size.w + gap, seconds_y, seconds_size.w + gap, s_clock_frame.size.h - s_seconds_offset_y));
+  layer_set_hidden(text_layer_get_layer(s_seconds_layer), false);
+  s_time_width = time_size.w;
+}
 
-  // Build base format depending on seconds preference
-  const char *fmt_24 = s_show_seconds ? "%H:%M:%S" : "%H:%M";
-  const char *fmt_12 = s_show_seconds ? "%I:%M:%S" : "%I:%M";
-  strftime(s_time_buffer, sizeof(s_time_buffer), clock_is_24h_style() ? fmt_24 : fmt_12, tick_time);
+// Hours and minutes: runs on MINUTE_UNIT (and when time settings change)
+static void update_time_display(struct tm *tick_time) {
+  strftime(s_time_buffer, sizeof(s_time_buffer), clock_is_24h_style() ? "%H:%M" : "%I:%M", tick_time);
 
   // Apply compact time: trim leading zero for 12h style (e.g., 08:15 -> 8:15)
   if (s_compact_time && !clock_is_24h_style()) {
@@ -325,106 +990,115 @@ static void update_time_display() {
   }
 
   text_layer_set_text(s_time_layer, s_time_buffer);
+  
+  // Re-center the HH:MM + seconds group only when the HH:MM width changed
+  if (s_show_seconds) {
+    GSize time_size = graphics_text_layout_get_content_size(
+        s_time_buffer, s_time_font, s_clock_frame,
+        GTextOverflowModeWordWrap, GTextAlignmentCenter);
+    s_render_stats.text_measures++;
+    if (time_size.w != s_time_width) {
+      layout_clock_layers();
+    }
+  }
 }
 
-static void update_date_display() {
-  time_t temp = time(NULL);
-  struct tm *tick_time = localtime(&temp);
+// Seconds only: runs on SECOND_UNIT when "Show Seconds" is enabled
+static void update_seconds_display(struct tm *tick_time) {
+  if (!s_show_seconds) return;
+  s_seconds_buffer[0] = (char)('0' + tick_time->tm_sec / 10);
+  s_seconds_buffer[1] = (char)('0' + tick_time->tm_sec % 10);
+  s_seconds_buffer[2] = '\0';
+  text_layer_set_text(s_seconds_layer, s_seconds_buffer);
+}
+
+// Date: runs on DAY_UNIT (and when the date format changes)
+static void update_date_display(struct tm *tick_time) {
+  char date_buffer[sizeof(s_date_buffer)];
 
   switch (s_date_format) {
     case 1: // DD-MM-YYYY
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%d-%m-%Y", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%d-%m-%Y", tick_time);
       break;
     case 2: // June 6, 2025
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%B %e, %Y", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%B %e, %Y", tick_time);
       break;
     case 3: // 6 June 2025
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%e %B %Y", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%e %B %Y", tick_time);
       break;
     case 4: // June 6
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%B %e", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%B %e", tick_time);
       break;
     case 5: // 6 June
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%e %B", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%e %B", tick_time);
       break;
     case 6: // Jun 6, 2025
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%b %e, %Y", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%b %e, %Y", tick_time);
       break;
     case 7: // 6 Jun 2025
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%e %b %Y", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%e %b %Y", tick_time);
       break;
     case 8: // Jun 6
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%b %e", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%b %e", tick_time);
       break;
     case 9: // 6 Jun
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%e %b", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%e %b", tick_time);
       break;
     case 10: // Friday, June 6
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%A, %B %e", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%A, %B %e", tick_time);
       break;
     case 11: // Fri, Jun 6
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%a, %b %e", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%a, %b %e", tick_time);
       break;
     case 12: // YYYY-MM-DD
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%Y-%m-%d", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%Y-%m-%d", tick_time);
       break;
     case 0: // MM-DD-YYYY
     default:
-      strftime(s_date_buffer, sizeof(s_date_buffer), "%m-%d-%Y", tick_time);
+      strftime(date_buffer, sizeof(date_buffer), "%m-%d-%Y", tick_time);
       break;
   }
   
+  // The date only changes once a day: skip the text update and font fitting otherwise
+  if (strcmp(date_buffer, s_date_buffer) == 0) {
+    return;
+  }
+  memcpy(s_date_buffer, date_buffer, sizeof(s_date_buffer));
+  
   // Apply text and dynamically scale font to fit the available space
   text_layer_set_text(s_date_layer, s_date_buffer);
 
-  // Dynamically choose the largest font that fits the date layer bounds
-  // Candidate fonts ordered from largest to smallest
-  static const char *k_date_font_keys[] = {
-    FONT_KEY_GOTHIC_28_BOLD,
-    FONT_KEY_GOTHIC_24_BOLD,
-    FONT_KEY_GOTHIC_18_BOLD,
-    FONT_KEY_GOTHIC_14
-  };
-  const int k_num_date_fonts = (int)(sizeof(k_date_font_keys) / sizeof(k_date_font_keys[0]));
-
-  Layer *date_layer = text_layer_get_layer(s_date_layer);
-  GRect bounds = layer_get_bounds(date_layer);
-
-  // Slight horizontal padding to avoid edge clipping
-  const int padding_w = 6;
-  GRect test_bounds = GRect(padding_w, 0, bounds.size.w - 2 * padding_w, bounds.size.h);
+  // Largest date font that fits the date layer bounds (memoized)
+  GRect bounds = layer_get_bounds(text_layer_get_layer(s_date_layer));
+  text_layer_set_font(s_date_layer, fit_text_font(s_date_buffer, bounds.size, &k_date_font_spec));
+}
 
-  for (int i = 0; i < k_num_date_fonts; i++) {
-    GFont test_font = fonts_get_system_font(k_date_font_keys[i]);
-    GSize size = graphics_text_layout_get_content_size(
-        s_date_buffer,
-        test_font,
-        test_bounds,
-        GTextOverflowModeWordWrap,
-        GTextAlignmentCenter);
-    if (size.w <= test_bounds.size.w && size.h <= test_bounds.size.h) {
-      text_layer_set_font(s_date_layer, test_font);
-      break;
-    }
-    // If none fit, the last iteration will use the smallest font below
-    if (i == k_num_date_fonts - 1) {
-      text_layer_set_font(s_date_layer, test_font);
-    }
-  }
+// Full clock render from the current local time (startup and settings changes)
+static void refresh_clock(void) {
+  time_t temp = time(NULL);
+  struct tm *tick_time = localtime(&temp);
+  update_time_display(tick_time);
+  layout_clock_layers();
+  update_seconds_display(tick_time);
+  update_date_display(tick_time);
 }
 
 static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
-  update_time_display();
-  update_date_display();
+  // Only redo the parts of the clock whose units actually changed
+  if (units_changed & (MINUTE_UNIT | HOUR_UNIT)) {
+    update_time_display(tick_time);
+  }
+  if (units_changed & SECOND_UNIT) {
+    update_seconds_display(tick_time);
+  }
+  if (units_changed & DAY_UNIT) {
+    update_date_display(tick_time);
+  }
   
-  // Minute-based refresh using configurable interval
+  // Minute-based refresh (see REFRESH SCHEDULER) and stale markers (see METRIC FRESHNESS)
   if (units_changed & MINUTE_UNIT) {
-    s_minutes_since_refresh++;
-    if (s_minutes_since_refresh >= s_refresh_frequency_minutes) {
-      APP_LOG(APP_LOG_LEVEL_INFO, "Refreshing Oura data (every %d min)", s_refresh_frequency_minutes);
-      fetch_oura_data();
-      s_minutes_since_refresh = 0;
-    }
+    update_stale_indicators(time(NULL));
+    refresh_scheduler_minute_tick(tick_time);
   }
 }
 
@@ -432,303 +1106,672 @@ static void tick_handler(struct tm *tick_time, TimeUnits units_changed) {
 // DYNAMIC LAYOUT SYSTEM
 // =============================================================================
 
-// Dynamic layout positioning function
-static void apply_dynamic_layout_positioning() {
-  if (!s_window) return; // Safety check
-  
-  Layer *window_layer = window_get_root_layer(s_window);
-  GRect bounds = layer_get_bounds(window_layer);
-  
-  if (s_layout_rows == 1) {
-    // Use larger time font in 1-row mode
-    text_layer_set_font(s_time_layer, fonts_get_system_font(FONT_KEY_BITHAM_42_BOLD));
-    // 1-row mode: Large complications, normal positioning
-    int row1_y_value = bounds.size.h - 79;  // Original position
-    int row1_y_emoji = bounds.size.h - 59;  // Original emoji position
-    
-    // Update row 1 positions (large size)
-    layer_set_frame(text_layer_get_layer(s_readiness_layer), 
-                    GRect(0, row1_y_value, bounds.size.w/3, 24));
-    layer_set_frame(text_layer_get_layer(s_readiness_label_layer), 
-                    GRect(0, row1_y_emoji, bounds.size.w/3, 24));
-    
-    layer_set_frame(text_layer_get_layer(s_sleep_layer), 
-                    GRect(bounds.size.w/3, row1_y_value, bounds.size.w/3, 24));
-    layer_set_frame(text_layer_get_layer(s_sleep_label_layer), 
-                    GRect(bounds.size.w/3, row1_y_emoji, bounds.size.w/3, 24));
-    
-    layer_set_frame(text_layer_get_layer(s_heart_rate_layer), 
-                    GRect(2*bounds.size.w/3, row1_y_value, bounds.size.w/3, 24));
-    layer_set_frame(text_layer_get_layer(s_heart_rate_label_layer), 
-                    GRect(2*bounds.size.w/3, row1_y_emoji, bounds.size.w/3, 24));
-    
-    // Set large fonts for 1-row mode
-    text_layer_set_font(s_readiness_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-    text_layer_set_font(s_readiness_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-    text_layer_set_font(s_sleep_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-    text_layer_set_font(s_sleep_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-    text_layer_set_font(s_heart_rate_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-    text_layer_set_font(s_heart_rate_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-    
-    // Hide row 2
-    layer_set_hidden(text_layer_get_layer(s_activity_layer), true);
-    layer_set_hidden(text_layer_get_layer(s_activity_label_layer), true);
-    layer_set_hidden(text_layer_get_layer(s_stress_layer), true);
-    layer_set_hidden(text_layer_get_layer(s_stress_label_layer), true);
-    
-  } else if (s_layout_rows == 2) {
-    // Use a slightly smaller time font in 2-row mode for breathing room
-    text_layer_set_font(s_time_layer, fonts_get_system_font(FONT_KEY_BITHAM_34_MEDIUM_NUMBERS));
-    // 2-row mode: Shrink row 1, move it up, add row 2 below, all same size
-    int row1_y_value = bounds.size.h - 90;  // Move row 1 up (moved down 1px)
-    int row1_y_emoji = bounds.size.h - 75;  // Move row 1 emoji up (moved down 1px)
-    int row2_y_value = bounds.size.h - 50;  // Row 2 position (moved down 1px)
-    int row2_y_emoji = bounds.size.h - 35;  // Row 2 emoji position (moved down 1px)
-    
-    // Update row 1 positions (smaller size, moved up)
-    layer_set_frame(text_layer_get_layer(s_readiness_layer), 
-                    GRect(0, row1_y_value, bounds.size.w/3, 20));
-    layer_set_frame(text_layer_get_layer(s_readiness_label_layer), 
-                    GRect(0, row1_y_emoji, bounds.size.w/3, 20));
-    
-    layer_set_frame(text_layer_get_layer(s_sleep_layer), 
-                    GRect(bounds.size.w/3, row1_y_value, bounds.size.w/3, 20));
-    layer_set_frame(text_layer_get_layer(s_sleep_label_layer), 
-                    GRect(bounds.size.w/3, row1_y_emoji, bounds.size.w/3, 20));
-    
-    layer_set_frame(text_layer_get_layer(s_heart_rate_layer), 
-                    GRect(2*bounds.size.w/3, row1_y_value, bounds.size.w/3, 20));
-    layer_set_frame(text_layer_get_layer(s_heart_rate_label_layer), 
-                    GRect(2*bounds.size.w/3, row1_y_emoji, bounds.size.w/3, 20));
-    
-    // Update row 2 positions (same size as shrunken row 1)
-    layer_set_frame(text_layer_get_layer(s_activity_layer), 
-                    GRect(0, row2_y_value, bounds.size.w/2, 20));
-    layer_set_frame(text_layer_get_layer(s_activity_label_layer), 
-                    GRect(0, row2_y_emoji, bounds.size.w/2, 20));
-    
-    layer_set_frame(text_layer_get_layer(s_stress_layer), 
-                    GRect(bounds.size.w/2, row2_y_value, bounds.size.w/2, 20));
-    layer_set_frame(text_layer_get_layer(s_stress_label_layer), 
-                    GRect(bounds.size.w/2, row2_y_emoji, bounds.size.w/2, 20));
-    
-    // Show row 2
-    layer_set_hidden(text_layer_get_layer(s_activity_layer), false);
-    layer_set_hidden(text_layer_get_layer(s_activity_label_layer), false);
-    layer_set_hidden(text_layer_get_layer(s_stress_layer), false);
-    layer_set_hidden(text_layer_get_layer(s_stress_label_layer), false);
-    
-    // Update fonts to smaller size for both rows
-    text_layer_set_font(s_readiness_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_readiness_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_sleep_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_sleep_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_heart_rate_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_heart_rate_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_activity_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_activity_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_stress_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-    text_layer_set_font(s_stress_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
+// Mark a metric cell for re-fitting and schedule a redraw of the grid
+static void mark_metric_cell_dirty(int position) {
+  if (position < 0 || position >= METRIC_CELL_COUNT) return;
+  s_metric_dirty_mask |= (uint8_t)(1 << position);
+  if (s_metrics_layer) {
+    layer_mark_dirty(s_metrics_layer);
   }
-  
-  APP_LOG(APP_LOG_LEVEL_INFO, "Applied dynamic layout positioning: %d rows", s_layout_rows);
 }
 
-// Helper function to get the correct layer and buffer for a measurement type at a position
-static void update_measurement_at_position(int measurement_type, int position) {
-  TextLayer *layer = NULL;
-  TextLayer *label_layer = NULL;
-  char *buffer = NULL;
-  char *value_text = ""; // blank until fetch completes
-  char *emoji_text = "";
-  char value_buffer[16];
-  
-  // Determine which layer and buffer to use based on position
-  switch (position) {
-    case 0: // Left position (using sleep layers)
-      layer = s_sleep_layer;
-      label_layer = s_sleep_label_layer;
-      buffer = s_sleep_buffer;
-      break;
-    case 1: // Middle position (using readiness layers)
-      layer = s_readiness_layer;
-      label_layer = s_readiness_label_layer;
-      buffer = s_readiness_buffer;
-      break;
-    case 2: // Right position (using heart rate layers)
-      layer = s_heart_rate_layer;
-      label_layer = s_heart_rate_label_layer;
-      buffer = s_heart_rate_buffer;
-      break;
-    case 3: // Row 2 Left position (using activity layers)
-      layer = s_activity_layer;
-      label_layer = s_activity_label_layer;
-      buffer = s_activity_buffer;
-      break;
-    case 4: // Row 2 Right position (using stress layers)
-      layer = s_stress_layer;
-      label_layer = s_stress_label_layer;
-      buffer = s_stress_buffer;
-      break;
-    default:
-      return; // Invalid position
+// -----------------------------------------------------------------------------
+// Layout specs: every frame for one (screen shape, row count, drawable area)
+// combination. A spec is computed once and cached; applying it only touches
+// frames that differ from what is already on screen.
+// -----------------------------------------------------------------------------
+
+typedef struct {
+  GSize area;                 // unobstructed drawable size this spec was built for
+  uint8_t rows;
+  GRect clock;
+  GRect date;
+  GRect sample_indicator;
+  GRect value[METRIC_CELL_COUNT];
+  GRect label[METRIC_CELL_COUNT];
+  uint8_t visible_cells;      // bit per cell
+  bool show_date;             // false when the metrics need the date's space (Quick View)
+  const char *cell_font_key;
+  const char *time_font_key;
+  const char *seconds_font_key;
+  int16_t seconds_offset_y;
+} LayoutSpec;
+
+#define LAYOUT_CACHE_SIZE 4
+static LayoutSpec s_layout_cache[LAYOUT_CACHE_SIZE];
+static uint8_t s_layout_cache_count = 0;
+static uint8_t s_layout_cache_next = 0;   // round-robin replacement slot
+static const char *s_clock_font_key = NULL;
+static GRect s_sample_indicator_frame;    // kept for the indicator layer, created on demand
+
+#if defined(PBL_ROUND)
+static int isqrt(int value) {
+  if (value <= 0) return 0;
+  int x = value, y = (x + 1) / 2;
+  while (y < x) {
+    x = y;
+    y = (x + value / x) / 2;
+  }
+  return x;
+}
+
+// Spread `count` cells across the chord of the round screen that the row's
+// lowest pixel still fits inside
+static void layout_round_row(LayoutSpec *spec, int first, int count, int value_y, int label_y,
+                             int cell_h, GSize area) {
+  int radius = area.w / 2;
+  int dy = label_y + cell_h - area.h / 2;
+  int half = isqrt(radius * radius - dy * dy) - 4;
+  if (half < count * 10) half = count * 10;
+  int col_w = 2 * half / count;
+  int x0 = area.w / 2 - half;
+  for (int i = 0; i < count; i++) {
+    spec->value[first + i] = GRect(x0 + i * col_w, value_y, col_w, cell_h);
+    spec->label[first + i] = GRect(x0 + i * col_w, label_y, col_w, cell_h);
   }
-  
-  // Get the value and text label based on measurement type (using text for Pebble Steel compatibility)
-  switch (measurement_type) {
-    case 0: // Readiness
-      emoji_text = "RDY";
-      if (s_readiness_data.data_available) {
-        snprintf(value_buffer, sizeof(value_buffer), "%d", s_readiness_data.readiness_score);
-        value_text = value_buffer;
-      } else if (s_fetch_completed) { value_text = "--"; }
-      break;
-    case 1: // Sleep
-      emoji_text = "SLP";
-      if (s_sleep_data.data_available) {
-        snprintf(value_buffer, sizeof(value_buffer), "%d", s_sleep_data.sleep_score);
-        value_text = value_buffer;
-      } else if (s_fetch_completed) { value_text = "--"; }
-      break;
-    case 2: // Heart Rate
-      emoji_text = "HR";
-      if (s_heart_rate_data.data_available) {
-        snprintf(value_buffer, sizeof(value_buffer), "%d", s_heart_rate_data.resting_heart_rate);
-        value_text = value_buffer;
-      } else if (s_fetch_completed) { value_text = "--"; }
-      break;
-    case 3: // Activity
-      emoji_text = "ACT";
-      if (s_activity_data.data_available && s_activity_data.activity_score > 0) {
-        snprintf(value_buffer, sizeof(value_buffer), "%d", s_activity_data.activity_score);
-        value_text = value_buffer;
-      } else if (s_fetch_completed) { value_text = "--"; }
-      break;
-    case 4: // Stress
-      emoji_text = "STR";
-      if (s_stress_data.data_available) {
-        int total_minutes = s_stress_data.stress_duration / 60;
-        int hours = total_minutes / 60;
-        int minutes = total_minutes % 60;
-        if (hours > 0) {
-          snprintf(value_buffer, sizeof(value_buffer), "%dh %dm", hours, minutes);
-        } else {
-          snprintf(value_buffer, sizeof(value_buffer), "%dm", minutes);
-        }
-        value_text = value_buffer;
-      } else if (s_fetch_completed) { value_text = "--"; }
-      break;
+}
+
+// Round screens: one row follows the bottom arc, two rows are chord-limited
+static void layout_metric_cells(LayoutSpec *spec, GSize area) {
+  if (spec->rows == 1) {
+    static const int16_t angles[3] = { -48, 0, 48 };   // degrees from straight down
+    int radius = area.w / 2 - 34;
+    int cx = area.w / 2;
+    int cy = area.h / 2;
+    for (int i = 0; i < 3; i++) {
+      int32_t angle = DEG_TO_TRIGANGLE(angles[i]);
+      int x = cx + (int)(sin_lookup(angle) * radius / TRIG_MAX_RATIO);
+      int y = cy + (int)(cos_lookup(angle) * radius / TRIG_MAX_RATIO);
+      spec->value[i] = GRect(x - 28, y - 20, 56, 24);
+      spec->label[i] = GRect(x - 28, y, 56, 24);
+    }
+    spec->visible_cells = 0x07;
+  } else {
+    layout_round_row(spec, 0, 3, area.h / 2 + 2, area.h / 2 + 17, 20, area);
+    layout_round_row(spec, 3, 2, area.h / 2 + 40, area.h / 2 + 55, 20, area);
+    spec->visible_cells = 0x1F;
   }
-  
-  // Update the display
-  snprintf(buffer, 16, "%s", value_text);
-  text_layer_set_text(layer, buffer);
-  
-  // Dynamically scale the metric value font to fit within its cell
-  if (layer) {
-    static const char *k_metric_font_keys[] = {
-      FONT_KEY_GOTHIC_24_BOLD,
-      FONT_KEY_GOTHIC_18_BOLD,
-      FONT_KEY_GOTHIC_14
-    };
-    const int k_num_metric_fonts = (int)(sizeof(k_metric_font_keys) / sizeof(k_metric_font_keys[0]));
-    Layer *metric_layer = text_layer_get_layer(layer);
-    GRect m_bounds = layer_get_bounds(metric_layer);
-    const int m_padding_w = 2; // tighter than date
-    GRect m_test = GRect(m_padding_w, 0, m_bounds.size.w - 2 * m_padding_w, m_bounds.size.h);
-    for (int i = 0; i < k_num_metric_fonts; i++) {
-      GFont f = fonts_get_system_font(k_metric_font_keys[i]);
-      GSize sz = graphics_text_layout_get_content_size(
-        buffer,
-        f,
-        m_test,
-        GTextOverflowModeFill,
-        GTextAlignmentCenter);
-      if (sz.w <= m_test.size.w && sz.h <= m_test.size.h) {
-        text_layer_set_font(layer, f);
-        break;
-      }
-      if (i == k_num_metric_fonts - 1) {
-        text_layer_set_font(layer, f);
-      }
+}
+#else
+// Rectangular screens: rows anchored to the bottom of the drawable area
+static void layout_metric_cells(LayoutSpec *spec, GSize area) {
+  int col3_w = area.w / 3;
+  int col2_w = area.w / 2;
+  if (spec->rows == 1) {
+    // 1-row mode: large complications
+    for (int i = 0; i < 3; i++) {
+      spec->value[i] = GRect(i * col3_w, area.h - 79, col3_w, 24);
+      spec->label[i] = GRect(i * col3_w, area.h - 59, col3_w, 24);
+    }
+    spec->visible_cells = 0x07;
+  } else {
+    // 2-row mode: row 1 shrunk and moved up, row 2 below, all same size
+    for (int i = 0; i < 3; i++) {
+      spec->value[i] = GRect(i * col3_w, area.h - 90, col3_w, 20);
+      spec->label[i] = GRect(i * col3_w, area.h - 75, col3_w, 20);
+    }
+    for (int i = 0; i < 2; i++) {
+      spec->value[3 + i] = GRect(i * col2_w, area.h - 50, col2_w, 20);
+      spec->label[3 + i] = GRect(i * col2_w, area.h - 35, col2_w, 20);
     }
+    spec->visible_cells = 0x1F;
   }
-  
-  // Update the label with emoji or text based on setting
-  if (label_layer) {
-    // Platform-aware emoji enablement: Aplite has the most restrictions.
-    // Prefer text on Aplite even if s_use_emoji is true.
-    bool can_use_emoji = s_use_emoji;
-#if defined(PBL_PLATFORM_APLITE)
-    can_use_emoji = false;
+}
 #endif
-    if (can_use_emoji) {
-      // Use emoji symbols for labels
-      switch (measurement_type) {
-        // IMPORTANT: Pebble emoji require Gothic fonts and Unicode escapes (\\UXXXXXXXX)
-        // Readiness: Flexed Biceps U+1F4AA (may be unsupported on some firmwares)
-        case 0: text_layer_set_text(label_layer, "\U0001F4AA"); break;
-        // Sleep: Sleeping Face U+1F634 (supported range)
-        case 1: text_layer_set_text(label_layer, "\U0001F634"); break;
-        // Heart Rate: Heart U+2764 (without VS-16)
-        case 2: text_layer_set_text(label_layer, "\U00002764"); break;
-        // Activity: Fire U+1F525
-        case 3: text_layer_set_text(label_layer, "\U0001F525"); break;
-        // Stress: Face with Open Mouth and Cold Sweat U+1F630 (supported range)
-        case 4: text_layer_set_text(label_layer, "\U0001F630"); break;
-        default: text_layer_set_text(label_layer, emoji_text); break;
-      }
-    } else {
-      // Use text labels
-      text_layer_set_text(label_layer, emoji_text);
+
+static void compute_layout_spec(LayoutSpec *spec, GSize area, uint8_t rows) {
+  memset(spec, 0, sizeof(*spec));
+  spec->area = area;
+  spec->rows = rows;
+  spec->clock = GRect(0, PBL_IF_ROUND_ELSE(5, 0), area.w, 50);
+  spec->date = GRect(0, PBL_IF_ROUND_ELSE(50, 45), area.w, 40); // tall enough for long dates
+  spec->sample_indicator = GRect(0, area.h - 16, area.w, 16);
+  if (rows == 1) {
+    // Larger time font in 1-row mode
+    spec->time_font_key = FONT_KEY_BITHAM_42_BOLD;
+    spec->seconds_font_key = FONT_KEY_GOTHIC_28_BOLD;
+    spec->seconds_offset_y = 14;
+    spec->cell_font_key = FONT_KEY_GOTHIC_24_BOLD;
+  } else {
+    // Slightly smaller time font in 2-row mode for breathing room
+    spec->time_font_key = FONT_KEY_BITHAM_34_MEDIUM_NUMBERS;
+    spec->seconds_font_key = FONT_KEY_GOTHIC_24_BOLD;
+    spec->seconds_offset_y = 11;
+    spec->cell_font_key = FONT_KEY_GOTHIC_18_BOLD;
+  }
+  layout_metric_cells(spec, area);
+  
+  // When an obstruction pushes the metrics up into the date, the date gives way
+  int metrics_top = area.h;
+  for (int i = 0; i < METRIC_CELL_COUNT; i++) {
+    if ((spec->visible_cells & (1 << i)) && spec->value[i].origin.y < metrics_top) {
+      metrics_top = spec->value[i].origin.y;
     }
   }
+  spec->show_date = metrics_top >= spec->date.origin.y + 30;
 }
 
-// Update all measurements according to current layout
-static void update_all_measurements() {
-  update_measurement_at_position(s_layout_left, 0);    // Left position
-  update_measurement_at_position(s_layout_middle, 1);  // Middle position
-  update_measurement_at_position(s_layout_right, 2);   // Right position
-  
-  // Update row 2 if visible
-  if (!layer_get_hidden(text_layer_get_layer(s_activity_layer))) {
-    update_measurement_at_position(s_layout_row2_left, 3);   // Row 2 Left position
-    update_measurement_at_position(s_layout_row2_right, 4);  // Row 2 Right position
+static const LayoutSpec *get_layout_spec(GSize area, uint8_t rows) {
+  for (int i = 0; i < s_layout_cache_count; i++) {
+    const LayoutSpec *spec = &s_layout_cache[i];
+    if (spec->rows == rows && spec->area.w == area.w && spec->area.h == area.h) {
+      return spec;
+    }
+  }
+  LayoutSpec *spec = &s_layout_cache[s_layout_cache_next];
+  s_layout_cache_next = (uint8_t)((s_layout_cache_next + 1) % LAYOUT_CACHE_SIZE);
+  if (s_layout_cache_count < LAYOUT_CACHE_SIZE) {
+    s_layout_cache_count++;
+  }
+  compute_layout_spec(spec, area, rows);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Computed layout spec: %d rows, %dx%d", rows, area.w, area.h);
+  return spec;
+}
+
+static bool set_layer_frame_if_changed(Layer *layer, GRect frame) {
+  GRect current = layer_get_frame(layer);
+  if (grect_equal(&current, &frame)) {
+    return false;
+  }
+  layer_set_frame(layer, frame);
+  return true;
+}
+
+static void set_layer_hidden_if_changed(Layer *layer, bool hidden) {
+  if (layer_get_hidden(layer) != hidden) {
+    layer_set_hidden(layer, hidden);
+  }
+}
+
+// Apply a spec, touching only what differs from the current screen
+static void apply_layout_spec(const LayoutSpec *spec) {
+  bool clock_changed = false;
+  if (!grect_equal(&s_clock_frame, &spec->clock)) {
+    s_clock_frame = spec->clock;
+    clock_changed = true;
+  }
+  if (s_clock_font_key != spec->time_font_key) {
+    s_clock_font_key = spec->time_font_key;
+    set_clock_fonts(spec->time_font_key, spec->seconds_font_key, spec->seconds_offset_y);
+  } else if (clock_changed) {
+    s_time_width = -1;
+    layout_clock_layers();
+  }
+  
+  if (s_date_layer) {
+    Layer *date_layer = text_layer_get_layer(s_date_layer);
+    set_layer_frame_if_changed(date_layer, spec->date);
+    set_layer_hidden_if_changed(date_layer, !spec->show_date);
+  }
+  s_sample_indicator_frame = spec->sample_indicator;
+  if (s_sample_indicator_layer) {
+    set_layer_frame_if_changed(text_layer_get_layer(s_sample_indicator_layer), spec->sample_indicator);
+  }
+  
+  GFont cell_font = fonts_get_system_font(spec->cell_font_key);
+  int changed_cells = 0;
+  for (int i = 0; i < METRIC_CELL_COUNT; i++) {
+    MetricCell *cell = &s_metric_cells[i];
+    bool hidden = !(spec->visible_cells & (1 << i));
+    if (cell->hidden == hidden && cell->label_font == cell_font &&
+        grect_equal(&cell->value_frame, &spec->value[i]) &&
+        grect_equal(&cell->label_frame, &spec->label[i])) {
+      continue;
+    }
+    cell->value_frame = spec->value[i];
+    cell->label_frame = spec->label[i];
+    cell->value_font = cell_font;
+    cell->label_font = cell_font;
+    cell->hidden = hidden;
+    mark_metric_cell_dirty(i); // geometry changed: re-fit this cell
+    changed_cells++;
+  }
+  
+  APP_LOG(APP_LOG_LEVEL_INFO, "Applied layout: %d rows, %d cells changed", spec->rows, changed_cells);
+}
+
+// Dynamic layout positioning: look up (or build) the spec for the current
+// row count and unobstructed area, then apply it
+static void apply_dynamic_layout_positioning() {
+  if (!s_window) return; // Safety check
+  
+  Layer *window_layer = window_get_root_layer(s_window);
+#if PBL_API_EXISTS(layer_get_unobstructed_bounds)
+  GRect area = layer_get_unobstructed_bounds(window_layer);
+#else
+  GRect area = layer_get_bounds(window_layer);
+#endif
+  uint8_t rows = (s_layout_rows == 2) ? 2 : 1;
+  apply_layout_spec(get_layout_spec(area.size, rows));
+}
+
+// Color configured for a measurement type (registry id)
+static GColor get_measurement_color(int measurement_type) {
+  if (measurement_type < 0 || measurement_type >= MEASUREMENT_TYPE_COUNT) {
+    return s_theme.time;
+  }
+  return s_theme.metric[k_metrics[measurement_type].color_slot];
+}
+
+// Pick the largest metric font that fits the cell's value rect
+static void fit_metric_cell_font(MetricCell *cell) {
+  cell->value_font = fit_text_font(cell->value, cell->value_frame.size, &k_metric_font_spec);
+}
+
+// Draw every visible metric cell; only dirty cells pay for font fitting
+static void metrics_layer_update_proc(Layer *layer, GContext *ctx) {
+  for (int i = 0; i < METRIC_CELL_COUNT; i++) {
+    MetricCell *cell = &s_metric_cells[i];
+    if (cell->hidden) {
+      continue;
+    }
+    if (s_metric_dirty_mask & (1 << i)) {
+      fit_metric_cell_font(cell);
+    }
+    graphics_context_set_text_color(ctx, cell->color);
+    graphics_draw_text(ctx, cell->value, cell->value_font, cell->value_frame,
+                       GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+    // Source marker in the value's top-right corner: dot = overdue phone value,
+    // ring = watch sensor reading
+    GPoint corner = GPoint(cell->value_frame.origin.x + cell->value_frame.size.w - 3,
+                           cell->value_frame.origin.y + 6);
+    if (cell->stale) {
+      graphics_context_set_fill_color(ctx, cell->color);
+      graphics_fill_circle(ctx, corner, 1);
+    } else if (cell->local) {
+      graphics_context_set_stroke_color(ctx, cell->color);
+      graphics_draw_circle(ctx, corner, 2);
+    }
+    if (cell->trend) {
+      // Small triangle in the top-left corner pointing the way the metric moves
+      graphics_context_set_stroke_color(ctx, cell->color);
+      int x = cell->value_frame.origin.x + 4;
+      int tip = cell->value_frame.origin.y + (cell->trend > 0 ? 3 : 7);
+      for (int r = 0; r < 3; r++) {
+        int y = tip + (cell->trend > 0 ? r : -r);
+        graphics_draw_line(ctx, GPoint(x - r, y), GPoint(x + r, y));
+      }
+    }
+    if (cell->label) {
+      graphics_draw_text(ctx, cell->label, cell->label_font, cell->label_frame,
+                         GTextOverflowModeWordWrap, GTextAlignmentCenter, NULL);
+    }
+  }
+  s_metric_dirty_mask = 0;
+}
+
+// Format one measurement (a k_metrics id) into its text cache using the
+// descriptor's value, availability flag and MetricFormat; on-watch health data
+// wins when present, otherwise the cell shows "--" once a fetch has completed
+static void format_measurement(int measurement_type) {
+  if (measurement_type < 0 || measurement_type >= MEASUREMENT_TYPE_COUNT) {
+    return;
+  }
+  const MetricDescriptor *metric = &k_metrics[measurement_type];
+  char *buffer = s_measurement_text[measurement_type];
+  int value = *metric->value;
+  uint16_t bit = (uint16_t)(1 << measurement_type);
+  
+  s_measurement_local_mask &= (uint16_t)~bit;
+  if (local_health_value(measurement_type, &value)) {
+    s_measurement_local_mask |= bit;
+    format_metric_value(buffer, metric->format, value);
+  } else if (*metric->available && !(metric->zero_is_missing && value == 0)) {
+    format_metric_value(buffer, metric->format, value);
+  } else {
+    // blank until fetch completes
+    snprintf(buffer, sizeof(s_measurement_text[0]), "%s", s_fetch_completed ? "--" : "");
+  }
+  s_render_stats.formats++;
+}
+
+// Text label (or emoji) for a measurement type (using text for Pebble Steel compatibility)
+static const char *get_measurement_label(int measurement_type) {
+  if (measurement_type < 0 || measurement_type >= MEASUREMENT_TYPE_COUNT) {
+    return "";
+  }
+  const MetricDescriptor *metric = &k_metrics[measurement_type];
+  // Platform-aware emoji enablement: Aplite has the most restrictions.
+  // Prefer text on Aplite even if s_use_emoji is true.
+  bool can_use_emoji = s_use_emoji;
+#if defined(PBL_PLATFORM_APLITE)
+  can_use_emoji = false;
+#endif
+  return (can_use_emoji && metric->emoji) ? metric->emoji : metric->label;
+}
+
+// Copy a cached measurement into a position's cell; dirties the cell only if it changed
+static void update_measurement_at_position(int measurement_type, int position) {
+  if (position < 0 || position >= METRIC_CELL_COUNT) {
+    return; // Invalid position
+  }
+  MetricCell *cell = &s_metric_cells[position];
+  bool valid_type = measurement_type >= 0 && measurement_type < MEASUREMENT_TYPE_COUNT;
+  const char *value_text = valid_type ? s_measurement_text[measurement_type] : "";
+  const char *label = get_measurement_label(measurement_type);
+  
+  // Only touch the cell (and schedule a redraw) when something visible changed
+  bool changed = false;
+  if (strcmp(cell->value, value_text) != 0) {
+    snprintf(cell->value, sizeof(cell->value), "%s", value_text);
+    changed = true;
+  }
+  if (cell->label != label) {
+    cell->label = label;
+    changed = true;
+  }
+  if (cell->measurement != measurement_type) {
+    cell->measurement = (int8_t)measurement_type;
+    cell->color = get_measurement_color(measurement_type);
+    changed = true;
+  }
+  bool local = valid_type && (s_measurement_local_mask & (1 << measurement_type));
+  if (cell->local != local) {
+    cell->local = local;
+    changed = true;
+  }
+  bool stale = !local && measurement_is_stale(measurement_type);
+  if (cell->stale != stale) {
+    cell->stale = stale;
+    changed = true;
+  }
+  int8_t trend = local ? 0 : history_trend(measurement_type);
+  if (cell->trend != trend) {
+    cell->trend = trend;
+    changed = true;
+  }
+  if (changed) {
+    s_render_stats.cell_updates++;
+    mark_metric_cell_dirty(position);
+  }
+}
+
+// Update all measurements according to current layout
+static void update_all_measurements() {
+  update_measurement_at_position(s_layout_left, 0);    // Left position
+  update_measurement_at_position(s_layout_middle, 1);  // Middle position
+  update_measurement_at_position(s_layout_right, 2);   // Right position
+  
+  // Update row 2 if visible
+  if (!s_metric_cells[3].hidden) {
+    update_measurement_at_position(s_layout_row2_left, 3);   // Row 2 Left position
+    update_measurement_at_position(s_layout_row2_right, 4);  // Row 2 Right position
   }
 }
 
 // =============================================================================
-// LEGACY DISPLAY FUNCTIONS (now call the dynamic system)
+// RENDER SCHEDULER
 // =============================================================================
+// Handlers only record what changed; a single deferred pass rebuilds the
+// affected measurements and cells once, however many updates arrived.
 
-static void update_heart_rate_display() {
+static void render_pass(void *data) {
+  s_render_timer = NULL;
+  uint8_t flags = s_render_dirty;
+  uint16_t measurements = s_measurement_dirty;
+  s_render_dirty = 0;
+  s_measurement_dirty = 0;
+  
+  if (flags & RENDER_DIRTY_LAYOUT) {
+    apply_dynamic_layout_positioning();
+  }
+  if (flags & RENDER_DIRTY_THEME) {
+    apply_theme_colors();
+  }
+  for (int i = 0; i < MEASUREMENT_TYPE_COUNT; i++) {
+    if (measurements & (1 << i)) {
+      format_measurement(i);
+    }
+  }
+  // Cells compare against their current text, so re-assigning all is cheap
   update_all_measurements();
+  
+  s_render_stats.passes++;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Render pass #%lu (%lu messages): %lu requests, %lu formats, %lu cell updates so far",
+          (unsigned long)s_render_stats.passes, (unsigned long)s_render_stats.messages,
+          (unsigned long)s_render_stats.requests,
+          (unsigned long)s_render_stats.formats, (unsigned long)s_render_stats.cell_updates);
 }
 
-static void update_readiness_display() {
-  update_all_measurements();
+// Record dirty state and schedule one render pass on the next event loop turn
+static void request_render(uint8_t flags) {
+  s_render_dirty |= flags;
+  s_render_stats.requests++;
+  if (!s_render_timer) {
+    s_render_timer = app_timer_register(0, render_pass, NULL);
+  }
 }
 
-static void update_sleep_display() {
-  update_all_measurements();
+static void mark_measurement_dirty(int measurement_type) {
+  if (measurement_type >= 0 && measurement_type < MEASUREMENT_TYPE_COUNT) {
+    s_measurement_dirty |= (uint16_t)(1 << measurement_type);
+  }
+  request_render(RENDER_DIRTY_METRICS);
 }
 
-static void update_activity_display() {
-  // Use flexible layout system for activity display
-  update_all_measurements();
+static void mark_all_measurements_dirty(void) {
+  s_measurement_dirty = (uint16_t)((1 << MEASUREMENT_TYPE_COUNT) - 1);
+  request_render(RENDER_DIRTY_METRICS);
 }
 
-static void update_stress_display() {
-  // Use flexible layout system for stress display
-  update_all_measurements();
+// =============================================================================
+// REFRESH SCHEDULER
+// =============================================================================
+// Decides when fetch_oura_data() runs: every s_refresh_frequency_minutes while
+// the phone app is reachable, paused while it is not (one catch-up fetch on
+// reconnect), spaced out exponentially after failed or unanswered requests,
+// and stretched overnight when Oura scores cannot change.
+
+#define REFRESH_MAX_BACKOFF         4      // interval doubles per failure, up to 16x
+#define REFRESH_MAX_INTERVAL_MIN    240    // backoff never pushes past this (unless configured higher)
+#define REFRESH_NIGHT_START_HOUR    0
+#define REFRESH_NIGHT_END_HOUR      6
+#define REFRESH_NIGHT_INTERVAL_MIN  120
+
+static bool s_phone_connected = true;
+static bool s_refresh_catch_up = false;    // a refresh came due while the phone was unreachable
+static uint8_t s_refresh_backoff = 0;      // consecutive failed refreshes
+
+static bool request_abort(void);
+
+static int refresh_interval_minutes(const struct tm *now) {
+  int interval = s_refresh_frequency_minutes;
+  if (now && now->tm_hour >= REFRESH_NIGHT_START_HOUR && now->tm_hour < REFRESH_NIGHT_END_HOUR &&
+      interval < REFRESH_NIGHT_INTERVAL_MIN) {
+    interval = REFRESH_NIGHT_INTERVAL_MIN;
+  }
+  int cap = s_refresh_frequency_minutes > REFRESH_MAX_INTERVAL_MIN ? s_refresh_frequency_minutes : REFRESH_MAX_INTERVAL_MIN;
+  interval <<= s_refresh_backoff;
+  return interval > cap ? cap : interval;
+}
+
+static void refresh_note_failure(const char *reason) {
+  if (s_refresh_backoff < REFRESH_MAX_BACKOFF) {
+    s_refresh_backoff++;
+  }
+  s_minutes_since_refresh = 0;
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Refresh failed (%s), backoff level %d", reason, s_refresh_backoff);
+}
+
+static void refresh_note_success(void) {
+  s_refresh_backoff = 0;
+}
+
+// Fetch now if the phone is reachable, otherwise remember to catch up on reconnect
+static void refresh_now(void) {
+  s_minutes_since_refresh = 0;
+  if (!s_phone_connected) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Phone disconnected: refresh deferred until reconnect");
+    s_refresh_catch_up = true;
+    return;
+  }
+  s_refresh_catch_up = false;
+  fetch_oura_data();
+}
+
+static void refresh_scheduler_minute_tick(struct tm *tick_time) {
+  s_minutes_since_refresh++;
+  int interval = refresh_interval_minutes(tick_time);
+  if (s_minutes_since_refresh < interval) {
+    return;
+  }
+  if (!s_phone_connected) {
+    // Hold one catch-up instead of waking the radio for requests that cannot succeed
+    s_refresh_catch_up = true;
+    return;
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "Refreshing Oura data (every %d min)", interval);
+  refresh_now();
+}
+
+static void app_connection_handler(bool connected) {
+  s_phone_connected = connected;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Phone app %s", connected ? "connected" : "disconnected");
+  if (!connected) {
+    // A request in flight will not be answered; retry on reconnect without backing off
+    if (request_abort()) {
+      s_refresh_catch_up = true;
+    }
+    return;
+  }
+  if (s_refresh_catch_up) {
+    refresh_now();
+  }
+}
+
+static void refresh_scheduler_init(void) {
+  s_phone_connected = connection_service_peek_pebble_app_connection();
+  connection_service_subscribe((ConnectionHandlers) {
+    .pebble_app_connection_handler = app_connection_handler
+  });
 }
 
 // =============================================================================
-// OURA API MODULE (Placeholder for future implementation)
+// OURA API MODULE
 // =============================================================================
+// One data request at a time. A request is IDLE, SENDING (handed to the
+// outbox, waiting for the send ack) or AWAITING_PAYLOAD (phone is fetching,
+// waiting for payload_complete). Triggers while a request is active coalesce
+// into it; a busy outbox is retried; a request that never completes times out.
+
+#define REQUEST_TIMEOUT_MS          (90 * 1000)
+#define REQUEST_BUSY_RETRY_MS       500
+#define REQUEST_MAX_BUSY_RETRIES    6
+
+typedef enum {
+  REQUEST_IDLE = 0,
+  REQUEST_SENDING,
+  REQUEST_AWAITING_PAYLOAD
+} RequestState;
+
+static RequestState s_request_state = REQUEST_IDLE;
+static uint8_t s_request_seq = 0;          // sent as the request_data value, never 0
+static uint8_t s_request_sources = 0;      // METRIC_BIT_* the phone should fetch (stale_mask)
+static bool s_refresh_all_sources = false; // next request ignores freshness (manual refresh)
+static uint8_t s_request_busy_retries = 0;
+static AppTimer *s_request_retry_timer = NULL;
+static AppTimer *s_request_timeout_timer = NULL;
+
+static void request_cancel_timers(void) {
+  if (s_request_retry_timer) {
+    app_timer_cancel(s_request_retry_timer);
+    s_request_retry_timer = NULL;
+  }
+  if (s_request_timeout_timer) {
+    app_timer_cancel(s_request_timeout_timer);
+    s_request_timeout_timer = NULL;
+  }
+}
+
+static void request_finish(bool success, const char *reason) {
+  if (s_request_state == REQUEST_IDLE) {
+    return;
+  }
+  request_cancel_timers();
+  s_request_state = REQUEST_IDLE;
+  if (success) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Request #%d complete", s_request_seq);
+    refresh_note_success();
+  } else {
+    refresh_note_failure(reason);
+  }
+}
+
+// Drop the active request without counting it as a failure (e.g. disconnect)
+static bool request_abort(void) {
+  if (s_request_state == REQUEST_IDLE) {
+    return false;
+  }
+  request_cancel_timers();
+  s_request_state = REQUEST_IDLE;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Request #%d abandoned", s_request_seq);
+  return true;
+}
+
+static void request_timeout_callback(void *data) {
+  s_request_timeout_timer = NULL;
+  request_finish(false, "no reply");
+}
+
+static void request_send(void);
+static void update_sample_indicator();
+
+static void request_retry_callback(void *data) {
+  s_request_retry_timer = NULL;
+  request_send();
+}
+
+static void request_send(void) {
+  DictionaryIterator *iter;
+  AppMessageResult result = app_message_outbox_begin(&iter);
+  if (result == APP_MSG_OK) {
+    dict_write_uint8(iter, MESSAGE_KEY_request_data, s_request_seq);
+    dict_write_uint8(iter, MESSAGE_KEY_stale_mask, s_request_sources);
+    result = app_message_outbox_send();
+  }
+  if (result == APP_MSG_OK) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Requested Oura data from phone (#%d, sources 0x%02x)",
+            s_request_seq, s_request_sources);
+    return;
+  }
+  if (result == APP_MSG_BUSY && s_request_busy_retries < REQUEST_MAX_BUSY_RETRIES) {
+    // Outbox still carrying an earlier message: try again shortly
+    s_request_busy_retries++;
+    s_request_retry_timer = app_timer_register(REQUEST_BUSY_RETRY_MS * s_request_busy_retries,
+                                               request_retry_callback, NULL);
+    return;
+  }
+  APP_LOG(APP_LOG_LEVEL_ERROR, "Request #%d could not be sent: %d", s_request_seq, (int)result);
+  request_finish(false, "send error");
+}
+
+// Matches outbox callbacks to the active request via the request_data value
+static bool request_is_active_message(DictionaryIterator *iterator) {
+  Tuple *t = dict_find(iterator, MESSAGE_KEY_request_data);
+  return t && s_request_state == REQUEST_SENDING && t->value->uint8 == s_request_seq;
+}
 
 static void request_oura_data() {
+  if (s_request_state != REQUEST_IDLE) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Request #%d already in flight, coalescing", s_request_seq);
+    return;
+  }
+  
+  // Only ask for the endpoints that are stale (see METRIC FRESHNESS)
+  s_request_sources = s_refresh_all_sources ? METRIC_SOURCE_ALL : metric_sources_to_fetch(time(NULL));
+  s_refresh_all_sources = false;
+  if (!s_request_sources) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "All metrics fresh, nothing to request");
+    // The snapshot is as good as a fetch: settle the face as payload_complete would
+    s_metrics_stale = false;
+    if (!s_fetch_completed) {
+      s_fetch_completed = true;
+      mark_all_measurements_dirty();
+    }
+    update_sample_indicator();
+    return;
+  }
+  
   // Request fresh data from JavaScript component
   // Show loading overlay if user has enabled it (allow on any refresh after initial startup)
   if (s_show_loading && !s_initial_startup) {
@@ -740,12 +1783,12 @@ static void request_oura_data() {
     APP_LOG(APP_LOG_LEVEL_INFO, "Loading overlay disabled by user (show_loading: %d)", s_show_loading);
   }
   
-  DictionaryIterator *iter;
-  app_message_outbox_begin(&iter);
-  dict_write_uint8(iter, MESSAGE_KEY_request_data, 1);
-  app_message_outbox_send();
-  
-  APP_LOG(APP_LOG_LEVEL_INFO, "Requested Oura data from phone");
+  s_request_seq = (uint8_t)(s_request_seq == 255 ? 1 : s_request_seq + 1);
+  s_request_busy_retries = 0;
+  s_request_state = REQUEST_SENDING;
+  // One deadline covers the send, the phone-side fetches and payload_complete
+  s_request_timeout_timer = app_timer_register(REQUEST_TIMEOUT_MS, request_timeout_callback, NULL);
+  request_send();
 }
 
 // =============================================================================
@@ -758,45 +1801,101 @@ static void debug_timer_callback(void *data) {
   update_debug_display(NULL);  // Clear debug message
 }
 
+// Heap report around optional UI allocations (compare with the overlay up and down)
+static void log_heap_usage(const char *where) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Heap %s: %u used, %u free", where,
+          (unsigned)heap_bytes_used(), (unsigned)heap_bytes_free());
+}
+
+// Loading overlay log: fixed slots used as a ring, so appending and evicting
+// the oldest line are O(1). The overlay text is only assembled when the logs
+// layer is visible, once per batch of appends. The ring lives on the heap
+// together with the logs layer, so it costs nothing while the overlay is down.
+#define LOG_SLOT_COUNT  8
+#define LOG_LINE_LEN    64
+
+typedef struct {
+  char lines[LOG_SLOT_COUNT][LOG_LINE_LEN];
+  char text[LOG_SLOT_COUNT * LOG_LINE_LEN]; // joined overlay text
+  uint8_t head;    // next slot to write
+  uint8_t count;
+} LoadingLog;
+
+static LoadingLog *s_loading_log = NULL;
+static AppTimer *s_log_render_timer = NULL;
+
+static void log_ring_clear(void) {
+  if (!s_loading_log) {
+    return;
+  }
+  s_loading_log->head = 0;
+  s_loading_log->count = 0;
+  s_loading_log->text[0] = '\0';
+}
+
+static void log_ring_append(const char *message) {
+  if (!s_loading_log) {
+    return;
+  }
+  // strncpy-style copy bounded by the slot; longer messages are truncated
+  char *slot = s_loading_log->lines[s_loading_log->head];
+  size_t i = 0;
+  for (; i < LOG_LINE_LEN - 1 && message[i]; i++) {
+    slot[i] = message[i];
+  }
+  slot[i] = '\0';
+  s_loading_log->head = (uint8_t)((s_loading_log->head + 1) % LOG_SLOT_COUNT);
+  if (s_loading_log->count < LOG_SLOT_COUNT) {
+    s_loading_log->count++;
+  }
+}
+
+static bool loading_logs_visible(void) {
+  return s_loading_logs_layer && s_loading_log;
+}
+
+// Join the ring (oldest first) into the overlay text
+static void render_loading_logs(void) {
+  if (!loading_logs_visible()) {
+    return;
+  }
+  char *out = s_loading_log->text;
+  uint8_t start = (uint8_t)((s_loading_log->head + LOG_SLOT_COUNT - s_loading_log->count) % LOG_SLOT_COUNT);
+  for (uint8_t n = 0; n < s_loading_log->count; n++) {
+    const char *line = s_loading_log->lines[(start + n) % LOG_SLOT_COUNT];
+    if (n) {
+      *out++ = '\n';
+    }
+    while (*line) {
+      *out++ = *line++;
+    }
+  }
+  *out = '\0';
+  text_layer_set_text(s_loading_logs_layer, s_loading_log->text);
+}
+
+static void log_render_timer_callback(void *data) {
+  s_log_render_timer = NULL;
+  render_loading_logs();
+}
+
 static void update_debug_display(const char* message) {
   // Respect user preference for debug visibility
   if (!s_show_debug) {
     return;
   }
   // Route debug logs to loading overlay only. Do not show on watchface.
-  if (!s_loading) {
+  // The ring is cleared whenever the overlay opens, so nothing is kept while hidden.
+  if (!s_loading || !loading_logs_visible()) {
     return; // Suppress debug logs once watchface is visible
   }
  
-  if (message && s_loading_logs_layer) {
-    // Append message to multi-line buffer (with newline if needed)
-    static char s_loading_logs_buffer[512];
-    static bool initialized = false;
-    if (!initialized) { s_loading_logs_buffer[0] = '\0'; initialized = true; }
- 
-    size_t cur_len = strlen(s_loading_logs_buffer);
-    size_t msg_len = strlen(message);
-    size_t need = (cur_len ? 1 : 0) + msg_len + 1; // newline + message + NUL
-    if (cur_len + need < sizeof(s_loading_logs_buffer)) {
-      if (cur_len) { s_loading_logs_buffer[cur_len++] = '\n'; s_loading_logs_buffer[cur_len] = '\0'; }
-      strncat(s_loading_logs_buffer, message, sizeof(s_loading_logs_buffer) - cur_len - 1);
-    } else {
-      // If full, drop oldest by finding first '\n'
-      char *first_nl = strchr(s_loading_logs_buffer, '\n');
-      if (first_nl) {
-        size_t remain = strlen(first_nl + 1);
-        memmove(s_loading_logs_buffer, first_nl + 1, remain + 1);
-      } else {
-        // Too long without newline; reset buffer
-        s_loading_logs_buffer[0] = '\0';
-      }
-      // Retry append after trimming
-      cur_len = strlen(s_loading_logs_buffer);
-      if (cur_len) { s_loading_logs_buffer[cur_len++] = '\n'; s_loading_logs_buffer[cur_len] = '\0'; }
-      strncat(s_loading_logs_buffer, message, sizeof(s_loading_logs_buffer) - cur_len - 1);
+  if (message) {
+    log_ring_append(message);
+    // Several debug lines usually arrive together; lay them out once
+    if (!s_log_render_timer) {
+      s_log_render_timer = app_timer_register(0, log_render_timer_callback, NULL);
     }
- 
-    text_layer_set_text(s_loading_logs_layer, s_loading_logs_buffer);
   }
 }
 
@@ -804,21 +1903,56 @@ static void update_debug_display(const char* message) {
 // SAMPLE DATA INDICATOR
 // =============================================================================
 
+// The indicator is empty for most of the app's life, so its layer only exists
+// while there is something to show. It sits below the metrics grid so the
+// loading overlay (added last) stays on top.
+static void create_sample_indicator_layer(void) {
+  if (s_sample_indicator_layer || !s_window || !s_metrics_layer) {
+    return;
+  }
+  s_sample_indicator_layer = text_layer_create(s_sample_indicator_frame);
+  text_layer_set_background_color(s_sample_indicator_layer, GColorClear);
+  text_layer_set_text_color(s_sample_indicator_layer, get_text_color());
+  text_layer_set_font(s_sample_indicator_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
+  text_layer_set_text_alignment(s_sample_indicator_layer, GTextAlignmentCenter);
+  layer_insert_below_sibling(text_layer_get_layer(s_sample_indicator_layer), s_metrics_layer);
+  log_heap_usage("after sample indicator create");
+}
+
+static void destroy_sample_indicator_layer(void) {
+  if (!s_sample_indicator_layer) {
+    return;
+  }
+  text_layer_destroy(s_sample_indicator_layer);
+  s_sample_indicator_layer = NULL;
+  log_heap_usage("after sample indicator destroy");
+}
+
 static void update_sample_indicator() {
   if (s_using_sample_data) {
-    snprintf(s_sample_indicator_buffer, sizeof(s_sample_indicator_buffer), "This is sample data, not your data!");
+    snprintf(s_sample_indicator_buffer, sizeof(s_sample_indicator_buffer), "Sample data");
+  } else if (s_metrics_stale && s_metrics_received_at) {
+    // Snapshot values shown until the background refresh lands
+    struct tm *received = localtime(&s_metrics_received_at);
+    strftime(s_sample_indicator_buffer, sizeof(s_sample_indicator_buffer),
+             clock_is_24h_style() ? "Cached %H:%M" : "Cached %I:%M", received);
   } else {
     s_sample_indicator_buffer[0] = '\0';  // Clear the buffer
   }
-  text_layer_set_text(s_sample_indicator_layer, s_sample_indicator_buffer);
+  if (s_sample_indicator_buffer[0] == '\0') {
+    destroy_sample_indicator_layer();
+    return;
+  }
+  create_sample_indicator_layer();
+  if (s_sample_indicator_layer) {
+    text_layer_set_text(s_sample_indicator_layer, s_sample_indicator_buffer);
+  }
 }
 
 static void fetch_oura_data() {
-  // Do NOT set any sample data. Leave fields blank until fetched.
+  // Do NOT set any sample data. Fields show the last snapshot (if any) until fetched.
   s_using_sample_data = false;
-  update_time_display();
-  update_date_display();
-  update_all_measurements();
+  mark_all_measurements_dirty();
   update_sample_indicator();
   
   // Request real data from phone
@@ -833,19 +1967,28 @@ static void fetch_oura_data() {
 static void window_load(Window *window) {
   Layer *window_layer = window_get_root_layer(window);
   GRect bounds = layer_get_bounds(window_layer);
+  resolve_theme();
   
   // Set background color based on theme
   window_set_background_color(window, get_background_color());
   
   // Time display (center top) - moved up 10 pixels for better positioning
-  s_time_layer = text_layer_create(
-      GRect(0, PBL_IF_ROUND_ELSE(5, 0), bounds.size.w, 50));
+  s_clock_frame = GRect(0, PBL_IF_ROUND_ELSE(5, 0), bounds.size.w, 50);
+  s_time_layer = text_layer_create(s_clock_frame);
   text_layer_set_background_color(s_time_layer, GColorClear);
   text_layer_set_text_color(s_time_layer, get_text_color());
   text_layer_set_font(s_time_layer, fonts_get_system_font(FONT_KEY_BITHAM_42_BOLD));
   text_layer_set_text_alignment(s_time_layer, GTextAlignmentCenter);
   layer_add_child(window_layer, text_layer_get_layer(s_time_layer));
   
+  // Seconds (own region to the right of HH:MM; positioned by layout_clock_layers)
+  s_seconds_layer = text_layer_create(GRect(0, 0, 0, 0));
+  text_layer_set_background_color(s_seconds_layer, GColorClear);
+  text_layer_set_text_color(s_seconds_layer, get_text_color());
+  text_layer_set_text_alignment(s_seconds_layer, GTextAlignmentLeft);
+  layer_add_child(window_layer, text_layer_get_layer(s_seconds_layer));
+  layer_set_hidden(text_layer_get_layer(s_seconds_layer), true);
+  
   // Date display (below time) - 20% bigger font for even better readability
   s_date_layer = text_layer_create(
       GRect(0, PBL_IF_ROUND_ELSE(50, 45), bounds.size.w, 40)); // Increased height for long dates
@@ -855,143 +1998,55 @@ static void window_load(Window *window) {
   text_layer_set_text_alignment(s_date_layer, GTextAlignmentCenter);
   layer_add_child(window_layer, text_layer_get_layer(s_date_layer));
   
-  // Debug status (moved down to accommodate date)
-  s_debug_layer = text_layer_create(
-      GRect(0, PBL_IF_ROUND_ELSE(85, 80), bounds.size.w, 15));
-  text_layer_set_background_color(s_debug_layer, GColorClear);
-  text_layer_set_text_color(s_debug_layer, get_text_color());
-  text_layer_set_font(s_debug_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_debug_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_debug_layer));
-  
-  // Sample indicator (moved down to accommodate date)
-  s_sample_indicator_layer = text_layer_create(
-      GRect(0, PBL_IF_ROUND_ELSE(105, 100), bounds.size.w, 20));
-  text_layer_set_background_color(s_sample_indicator_layer, GColorClear);
-  text_layer_set_text_color(s_sample_indicator_layer, get_text_color());
-  text_layer_set_font(s_sample_indicator_layer, fonts_get_system_font(FONT_KEY_GOTHIC_14));
-  text_layer_set_text_alignment(s_sample_indicator_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_sample_indicator_layer));
+  // Debug text is routed to the loading overlay logs, and the sample indicator
+  // and loading overlay are created on demand (see update_sample_indicator and
+  // show_loading_overlay), so nothing else is allocated up front; the
+  // indicator's frame comes from the layout spec applied below.
   
   // Configure input when window is ready
   window_set_click_config_provider(window, click_config_provider);
   
-  // Top row for readiness, sleep, heart rate (3 columns) - moved down 2px, size up 20%
-  // Readiness (top row left)
-  s_readiness_layer = text_layer_create(
-      GRect(0, bounds.size.h - 79, bounds.size.w/3, 24));
-  text_layer_set_background_color(s_readiness_layer, GColorClear);
-  text_layer_set_text_color(s_readiness_layer, get_text_color());
-  text_layer_set_font(s_readiness_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_readiness_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_readiness_layer));
-
-  // Readiness Label (emoji)
-  s_readiness_label_layer = text_layer_create(
-      GRect(0, bounds.size.h - 59, bounds.size.w/3, 24));
-  text_layer_set_background_color(s_readiness_label_layer, GColorClear);
-  text_layer_set_text_color(s_readiness_label_layer, get_text_color());
-  text_layer_set_font(s_readiness_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_readiness_label_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_readiness_label_layer, "🎉");
-  layer_add_child(window_layer, text_layer_get_layer(s_readiness_label_layer));
-
-  // Sleep (top row middle)
-  s_sleep_layer = text_layer_create(
-      GRect(bounds.size.w/3, bounds.size.h - 79, bounds.size.w/3, 24));
-  text_layer_set_background_color(s_sleep_layer, GColorClear);
-  text_layer_set_text_color(s_sleep_layer, get_text_color());
-  text_layer_set_font(s_sleep_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_sleep_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_sleep_layer));
-
-  // Sleep Label (emoji)
-  s_sleep_label_layer = text_layer_create(
-      GRect(bounds.size.w/3, bounds.size.h - 59, bounds.size.w/3, 24));
-  text_layer_set_background_color(s_sleep_label_layer, GColorClear);
-  text_layer_set_text_color(s_sleep_label_layer, get_text_color());
-  text_layer_set_font(s_sleep_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_sleep_label_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_sleep_label_layer, "😴");
-  layer_add_child(window_layer, text_layer_get_layer(s_sleep_label_layer));
-
-  // Heart Rate (top row right)
-  s_heart_rate_layer = text_layer_create(
-      GRect(2*bounds.size.w/3, bounds.size.h - 79, bounds.size.w/3, 24));
-  text_layer_set_background_color(s_heart_rate_layer, GColorClear);
-  text_layer_set_text_color(s_heart_rate_layer, get_text_color());
-  text_layer_set_font(s_heart_rate_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_heart_rate_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_heart_rate_layer));
-
-  // Heart Rate Label (emoji)
-  s_heart_rate_label_layer = text_layer_create(
-      GRect(2*bounds.size.w/3, bounds.size.h - 59, bounds.size.w/3, 24));
-  text_layer_set_background_color(s_heart_rate_label_layer, GColorClear);
-  text_layer_set_text_color(s_heart_rate_label_layer, get_text_color());
-  text_layer_set_font(s_heart_rate_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_heart_rate_label_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_heart_rate_label_layer, "❤");
-  layer_add_child(window_layer, text_layer_get_layer(s_heart_rate_label_layer));
-
-  // Bottom row for activity and stress (2 columns) - HIDDEN BY DEFAULT (1-row layout)
-  // Activity (bottom row left)
-  s_activity_layer = text_layer_create(
-      GRect(0, bounds.size.h - 41, bounds.size.w/2, 20));
-  text_layer_set_background_color(s_activity_layer, GColorClear);
-  text_layer_set_text_color(s_activity_layer, get_text_color());
-  text_layer_set_font(s_activity_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text_alignment(s_activity_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_activity_layer));
-  layer_set_hidden(text_layer_get_layer(s_activity_layer), true); // Hidden by default
-
-  // Activity Label (emoji)
-  s_activity_label_layer = text_layer_create(
-      GRect(0, bounds.size.h - 21, bounds.size.w/2, 20));
-  text_layer_set_background_color(s_activity_label_layer, GColorClear);
-  text_layer_set_text_color(s_activity_label_layer, get_text_color());
-  text_layer_set_font(s_activity_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text_alignment(s_activity_label_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_activity_label_layer, "🔥");
-  layer_add_child(window_layer, text_layer_get_layer(s_activity_label_layer));
-  layer_set_hidden(text_layer_get_layer(s_activity_label_layer), true); // Hidden by default
-
-  // Stress (bottom row right)
-  s_stress_layer = text_layer_create(
-      GRect(bounds.size.w/2, bounds.size.h - 41, bounds.size.w/2, 20));
-  text_layer_set_background_color(s_stress_layer, GColorClear);
-  text_layer_set_text_color(s_stress_layer, get_text_color());
-  text_layer_set_font(s_stress_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text_alignment(s_stress_layer, GTextAlignmentCenter);
-  layer_add_child(window_layer, text_layer_get_layer(s_stress_layer));
-  layer_set_hidden(text_layer_get_layer(s_stress_layer), true); // Hidden by default
-
-  // Stress Label (emoji)
-  s_stress_label_layer = text_layer_create(
-      GRect(bounds.size.w/2, bounds.size.h - 21, bounds.size.w/2, 20));
-  text_layer_set_background_color(s_stress_label_layer, GColorClear);
-  text_layer_set_text_color(s_stress_label_layer, get_text_color());
-  text_layer_set_font(s_stress_label_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18_BOLD));
-  text_layer_set_text_alignment(s_stress_label_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_stress_label_layer, "STR");
-  layer_add_child(window_layer, text_layer_get_layer(s_stress_label_layer));
-  layer_set_hidden(text_layer_get_layer(s_stress_label_layer), true); // Hidden by default
-
-  // Loading overlay (top-most): deep green background with "Loading..." header and logs below
-  s_loading_layer = layer_create(bounds);
-  layer_set_update_proc(s_loading_layer, loading_layer_update_proc);
-  layer_add_child(window_layer, s_loading_layer);
-  
-  // Big bold title at top
-  s_loading_text_layer = text_layer_create(GRect(0, 4, bounds.size.w, 28));
-  text_layer_set_background_color(s_loading_text_layer, GColorClear);
-  text_layer_set_text_color(s_loading_text_layer, GColorWhite);
-  text_layer_set_font(s_loading_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
-  text_layer_set_text_alignment(s_loading_text_layer, GTextAlignmentCenter);
-  text_layer_set_text(s_loading_text_layer, "Loading...");
-  layer_add_child(window_layer, text_layer_get_layer(s_loading_text_layer));
+  // Metrics grid: a single layer draws every value/label cell (frames set by layout)
+  for (int i = 0; i < METRIC_CELL_COUNT; i++) {
+    s_metric_cells[i].measurement = -1;
+    s_metric_cells[i].hidden = (i >= 3); // Row 2 hidden by default
+    s_metric_cells[i].stale = false;
+    s_metric_cells[i].local = false;
+    s_metric_cells[i].trend = 0;
+    s_metric_cells[i].color = get_text_color();
+    s_metric_cells[i].label = NULL;
+    s_metric_cells[i].value[0] = '\0';
+  }
+  s_metrics_layer = layer_create(bounds);
+  layer_set_update_proc(s_metrics_layer, metrics_layer_update_proc);
+  layer_add_child(window_layer, s_metrics_layer);
+
+  // Apply initial dynamic layout positioning (defaults to 1-row layout)
+  apply_dynamic_layout_positioning();
 
-  // Multi-line debug logs under the title
+  // Ensure initial time/date render uses scaled fonts before first tick
+  s_date_buffer[0] = '\0'; // new date layer: force the date to be set and fitted
+  refresh_clock();
+  log_heap_usage("after window load");
+}
+
+static void loading_layer_update_proc(Layer *layer, GContext *ctx) {
+  // Oxford Blue background for loading overlay (high contrast with white text)
+  graphics_context_set_fill_color(ctx, GColorOxfordBlue);
+  graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+}
+
+// Multi-line debug logs under the title; only built when debug output is on
+static void create_loading_logs(GRect bounds) {
+  if (s_loading_logs_layer || !s_show_debug) {
+    return;
+  }
+  s_loading_log = malloc(sizeof(LoadingLog));
+  if (!s_loading_log) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "No heap for loading logs");
+    return;
+  }
+  log_ring_clear();
   int logs_y = 4 + 28 + 4;
   s_loading_logs_layer = text_layer_create(GRect(4, logs_y, bounds.size.w - 8, bounds.size.h - logs_y - 4));
   text_layer_set_background_color(s_loading_logs_layer, GColorClear);
@@ -999,71 +2054,90 @@ static void window_load(Window *window) {
   text_layer_set_font(s_loading_logs_layer, fonts_get_system_font(FONT_KEY_GOTHIC_18));
   text_layer_set_text_alignment(s_loading_logs_layer, GTextAlignmentLeft);
   text_layer_set_overflow_mode(s_loading_logs_layer, GTextOverflowModeWordWrap);
-  text_layer_set_text(s_loading_logs_layer, "");
-  layer_add_child(window_layer, text_layer_get_layer(s_loading_logs_layer));
-  
-  // Initialize loading overlay as hidden by default, but don't force s_loading state
-  // The loading screen will be shown/hidden based on user preference and data requests
-  layer_set_hidden(s_loading_layer, true);
-  layer_set_hidden(text_layer_get_layer(s_loading_text_layer), true);
-  layer_set_hidden(text_layer_get_layer(s_loading_logs_layer), true);
+  text_layer_set_text(s_loading_logs_layer, s_loading_log->text);
+  layer_add_child(window_get_root_layer(s_window), text_layer_get_layer(s_loading_logs_layer));
+}
 
-  // We no longer want debug text on the main watchface; hide it permanently
-  if (s_debug_layer) {
-    layer_set_hidden(text_layer_get_layer(s_debug_layer), true);
+static void destroy_loading_logs(void) {
+  if (s_log_render_timer) { app_timer_cancel(s_log_render_timer); s_log_render_timer = NULL; }
+  if (s_loading_logs_layer) {
+    text_layer_destroy(s_loading_logs_layer);
+    s_loading_logs_layer = NULL;
   }
-  
-  // Apply initial dynamic layout positioning (defaults to 1-row layout)
-  apply_dynamic_layout_positioning();
-
-  // Ensure initial time/date render uses scaled fonts before first tick
-  update_time_display();
-  update_date_display();
+  free(s_loading_log);
+  s_loading_log = NULL;
 }
 
-static void loading_layer_update_proc(Layer *layer, GContext *ctx) {
-  // Oxford Blue background for loading overlay (high contrast with white text)
-  graphics_context_set_fill_color(ctx, GColorOxfordBlue);
-  graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
+static void destroy_loading_overlay(void) {
+  destroy_loading_logs();
+  if (s_loading_text_layer) {
+    text_layer_destroy(s_loading_text_layer);
+    s_loading_text_layer = NULL;
+  }
+  if (s_loading_layer) {
+    layer_destroy(s_loading_layer);
+    s_loading_layer = NULL;
+  }
 }
 
 static void show_loading_overlay(void) {
-  // Make loading UI visible and clear logs area
   s_loading = true;
-  if (s_loading_layer) layer_set_hidden(s_loading_layer, false);
-  if (s_loading_text_layer) layer_set_hidden(text_layer_get_layer(s_loading_text_layer), false);
-  if (s_loading_logs_layer) {
-    text_layer_set_text(s_loading_logs_layer, "");
-    layer_set_hidden(text_layer_get_layer(s_loading_logs_layer), false);
+  if (!s_window) {
+    return;
+  }
+  if (s_loading_layer) {
+    log_ring_clear();  // already up: start a fresh log for this request
+    render_loading_logs();
+    return;
   }
+  // Loading overlay (top-most): deep blue background with "Loading..." header and logs below
+  Layer *window_layer = window_get_root_layer(s_window);
+  GRect bounds = layer_get_bounds(window_layer);
+  s_loading_layer = layer_create(bounds);
+  layer_set_update_proc(s_loading_layer, loading_layer_update_proc);
+  layer_add_child(window_layer, s_loading_layer);
+  
+  // Big bold title at top
+  s_loading_text_layer = text_layer_create(GRect(0, 4, bounds.size.w, 28));
+  text_layer_set_background_color(s_loading_text_layer, GColorClear);
+  text_layer_set_text_color(s_loading_text_layer, GColorWhite);
+  text_layer_set_font(s_loading_text_layer, fonts_get_system_font(FONT_KEY_GOTHIC_24_BOLD));
+  text_layer_set_text_alignment(s_loading_text_layer, GTextAlignmentCenter);
+  text_layer_set_text(s_loading_text_layer, "Loading...");
+  layer_add_child(window_layer, text_layer_get_layer(s_loading_text_layer));
+  
+  create_loading_logs(bounds);
+  log_heap_usage("with loading overlay");
 }
 
 static void hide_loading_overlay(void) {
   if (s_loading) {
     s_loading = false;
-    if (s_loading_layer) layer_set_hidden(s_loading_layer, true);
-    if (s_loading_text_layer) layer_set_hidden(text_layer_get_layer(s_loading_text_layer), true);
-    if (s_loading_logs_layer) layer_set_hidden(text_layer_get_layer(s_loading_logs_layer), true);
+    if (s_loading_layer) {
+      destroy_loading_overlay();
+      log_heap_usage("after loading overlay");
+    }
+  }
+}
+
+// Drop optional UI that a settings change has switched off
+static void release_disabled_layers(void) {
+  if (!s_show_loading && s_loading_layer) {
+    hide_loading_overlay();
+  } else if (!s_show_debug && s_loading_logs_layer) {
+    destroy_loading_logs();
+    log_heap_usage("after loading logs");
   }
 }
 
 static void window_unload(Window *window) {
   text_layer_destroy(s_time_layer);
+  text_layer_destroy(s_seconds_layer);
   text_layer_destroy(s_date_layer);
-  text_layer_destroy(s_debug_layer);
-  text_layer_destroy(s_sample_indicator_layer);
-  text_layer_destroy(s_heart_rate_layer);
-  text_layer_destroy(s_heart_rate_label_layer);
-  text_layer_destroy(s_readiness_layer);
-  text_layer_destroy(s_readiness_label_layer);
-  text_layer_destroy(s_sleep_layer);
-  text_layer_destroy(s_sleep_label_layer);
-  text_layer_destroy(s_activity_layer);
-  text_layer_destroy(s_activity_label_layer);
-  text_layer_destroy(s_stress_layer);
-  text_layer_destroy(s_stress_label_layer);
-  if (s_loading_text_layer) text_layer_destroy(s_loading_text_layer);
-  if (s_loading_layer) layer_destroy(s_loading_layer);
+  destroy_sample_indicator_layer();
+  layer_destroy(s_metrics_layer);
+  s_metrics_layer = NULL;
+  destroy_loading_overlay();
   if (s_loading_hide_timer) { app_timer_cancel(s_loading_hide_timer); s_loading_hide_timer = NULL; }
 }
 
@@ -1074,21 +2148,21 @@ static void window_unload(Window *window) {
 static void select_long_click_handler(ClickRecognizerRef recognizer, void *context) {
   // Allow overlay on manual trigger even if it's the first run
   s_initial_startup = false;
-  s_minutes_since_refresh = 0;
   APP_LOG(APP_LOG_LEVEL_INFO, "SELECT long-click detected: forcing refresh");
   update_debug_display("Manual refresh requested...");
   vibes_short_pulse();
-  fetch_oura_data();
+  s_refresh_all_sources = true;
+  refresh_now();
 }
 
 static void select_click_handler(ClickRecognizerRef recognizer, void *context) {
   // Alternate manual refresh on single press
   s_initial_startup = false;
-  s_minutes_since_refresh = 0;
   APP_LOG(APP_LOG_LEVEL_INFO, "SELECT single-click detected: forcing refresh");
   update_debug_display("Manual refresh requested...");
   vibes_short_pulse();
-  fetch_oura_data();
+  s_refresh_all_sources = true;
+  refresh_now();
 }
 
 static void click_config_provider(void *context) {
@@ -1098,335 +2172,726 @@ static void click_config_provider(void *context) {
   window_single_click_subscribe(BUTTON_ID_SELECT, select_click_handler);
 }
 
+// =============================================================================
+// SETTINGS STORAGE
+// =============================================================================
+// All watch settings live in one packed, versioned blob under
+// PERSIST_KEY_SETTINGS: one persist_read_data at startup, and a write-behind
+// flush that only touches flash when a field actually changed (the phone
+// re-sends every setting on each refresh).
+
+#define PERSIST_KEY_SETTINGS            3000
+#define SETTINGS_BLOB_VERSION           1
+#define SETTINGS_FLUSH_DELAY_MS         5000
+
+#define SETTINGS_FLAG_SHOW_DEBUG        (1 << 0)
+#define SETTINGS_FLAG_SHOW_LOADING      (1 << 1)
+#define SETTINGS_FLAG_SHOW_SECONDS      (1 << 2)
+#define SETTINGS_FLAG_COMPACT_TIME      (1 << 3)
+#define SETTINGS_FLAG_USE_EMOJI         (1 << 4)
+
+typedef struct __attribute__((__packed__)) {
+  uint8_t version;
+  uint8_t flags;                  // SETTINGS_FLAG_*
+  uint16_t refresh_frequency;     // minutes
+  int8_t theme_mode;
+  int8_t custom_color_index;
+  int8_t background_color;        // palette indexes, see get_palette_color()
+  int8_t time_color;
+  int8_t date_color;
+  int8_t readiness_color;
+  int8_t sleep_color;
+  int8_t heart_rate_color;
+  int8_t activity_color;
+  int8_t stress_color;
+} SettingsBlob;
+
+static SettingsBlob s_settings_saved;      // what is currently in flash
+
+// Values outside these ranges would not survive the blob's field widths, so
+// they are clamped before they reach the in-memory settings
+#define SETTINGS_PALETTE_MAX            63
+#define REFRESH_FREQUENCY_MIN           1
+#define REFRESH_FREQUENCY_MAX           (24 * 60)
+
+static int clamp_palette_index(int index) {
+  return index < 0 ? 0 : (index > SETTINGS_PALETTE_MAX ? SETTINGS_PALETTE_MAX : index);
+}
+
+static int clamp_refresh_frequency(int minutes) {
+  return minutes < REFRESH_FREQUENCY_MIN ? REFRESH_FREQUENCY_MIN :
+         (minutes > REFRESH_FREQUENCY_MAX ? REFRESH_FREQUENCY_MAX : minutes);
+}
+static AppTimer *s_settings_flush_timer = NULL;
+
+static void pack_settings(SettingsBlob *blob) {
+  memset(blob, 0, sizeof(*blob));
+  blob->version = SETTINGS_BLOB_VERSION;
+  blob->flags = (s_show_debug ? SETTINGS_FLAG_SHOW_DEBUG : 0) |
+                (s_show_loading ? SETTINGS_FLAG_SHOW_LOADING : 0) |
+                (s_show_seconds ? SETTINGS_FLAG_SHOW_SECONDS : 0) |
+                (s_compact_time ? SETTINGS_FLAG_COMPACT_TIME : 0) |
+                (s_use_emoji ? SETTINGS_FLAG_USE_EMOJI : 0);
+  blob->refresh_frequency = (uint16_t)s_refresh_frequency_minutes;
+  blob->theme_mode = (int8_t)s_theme_mode;
+  blob->custom_color_index = (int8_t)s_custom_color_index;
+  blob->background_color = (int8_t)s_background_color;
+  blob->time_color = (int8_t)s_time_color;
+  blob->date_color = (int8_t)s_date_color;
+  blob->readiness_color = (int8_t)s_readiness_color;
+  blob->sleep_color = (int8_t)s_sleep_color;
+  blob->heart_rate_color = (int8_t)s_heart_rate_color;
+  blob->activity_color = (int8_t)s_activity_color;
+  blob->stress_color = (int8_t)s_stress_color;
+}
+
+static void unpack_settings(const SettingsBlob *blob) {
+  s_show_debug = (blob->flags & SETTINGS_FLAG_SHOW_DEBUG) != 0;
+  s_show_loading = (blob->flags & SETTINGS_FLAG_SHOW_LOADING) != 0;
+  s_show_seconds = (blob->flags & SETTINGS_FLAG_SHOW_SECONDS) != 0;
+  s_compact_time = (blob->flags & SETTINGS_FLAG_COMPACT_TIME) != 0;
+  s_use_emoji = (blob->flags & SETTINGS_FLAG_USE_EMOJI) != 0;
+  s_refresh_frequency_minutes = blob->refresh_frequency;
+  s_theme_mode = blob->theme_mode;
+  s_custom_color_index = blob->custom_color_index;
+  s_background_color = blob->background_color;
+  s_time_color = blob->time_color;
+  s_date_color = blob->date_color;
+  s_readiness_color = blob->readiness_color;
+  s_sleep_color = blob->sleep_color;
+  s_heart_rate_color = blob->heart_rate_color;
+  s_activity_color = blob->activity_color;
+  s_stress_color = blob->stress_color;
+}
+
+// Write the blob if it differs from what is already stored
+static void flush_settings(void) {
+  if (s_settings_flush_timer) {
+    app_timer_cancel(s_settings_flush_timer);
+    s_settings_flush_timer = NULL;
+  }
+  SettingsBlob blob;
+  pack_settings(&blob);
+  if (memcmp(&blob, &s_settings_saved, sizeof(blob)) == 0) {
+    return;
+  }
+  int written = persist_write_data(PERSIST_KEY_SETTINGS, &blob, sizeof(blob));
+  if (written == (int)sizeof(blob)) {
+    s_settings_saved = blob;
+    APP_LOG(APP_LOG_LEVEL_INFO, "Settings saved (%d bytes)", written);
+  } else {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Settings write failed: %d", written);
+  }
+}
+
+static void settings_flush_timer_callback(void *data) {
+  s_settings_flush_timer = NULL;
+  flush_settings();
+}
+
+// Called when a message touched persisted settings; the write is deferred so
+// a burst of settings messages costs at most one flash write
+static void schedule_settings_flush(void) {
+  if (s_settings_flush_timer) {
+    app_timer_reschedule(s_settings_flush_timer, SETTINGS_FLUSH_DELAY_MS);
+  } else {
+    s_settings_flush_timer = app_timer_register(SETTINGS_FLUSH_DELAY_MS, settings_flush_timer_callback, NULL);
+  }
+}
+
+// One-time import of the per-key values used by earlier versions
+static void migrate_legacy_settings(void) {
+  static const uint32_t legacy_keys[] = {
+    PERSIST_KEY_SHOW_DEBUG, PERSIST_KEY_REFRESH_FREQUENCY, PERSIST_KEY_SHOW_LOADING,
+    PERSIST_KEY_SHOW_SECONDS, PERSIST_KEY_COMPACT_TIME, PERSIST_KEY_THEME_MODE,
+    PERSIST_KEY_CUSTOM_COLOR, PERSIST_KEY_USE_EMOJI, PERSIST_KEY_BG_COLOR,
+    PERSIST_KEY_TIME_COLOR, PERSIST_KEY_DATE_COLOR, PERSIST_KEY_READINESS_COLOR,
+    PERSIST_KEY_SLEEP_COLOR, PERSIST_KEY_HEART_COLOR, PERSIST_KEY_ACTIVITY_COLOR,
+    PERSIST_KEY_STRESS_COLOR
+  };
+  bool migrated = false;
+  for (size_t i = 0; i < sizeof(legacy_keys) / sizeof(legacy_keys[0]); i++) {
+    uint32_t key = legacy_keys[i];
+    if (!persist_exists(key)) continue;
+    migrated = true;
+    switch (key) {
+      case PERSIST_KEY_SHOW_DEBUG:        s_show_debug = persist_read_bool(key); break;
+      case PERSIST_KEY_REFRESH_FREQUENCY: s_refresh_frequency_minutes = clamp_refresh_frequency(persist_read_int(key)); break;
+      case PERSIST_KEY_SHOW_LOADING:      s_show_loading = persist_read_bool(key); break;
+      case PERSIST_KEY_SHOW_SECONDS:      s_show_seconds = persist_read_bool(key); break;
+      case PERSIST_KEY_COMPACT_TIME:      s_compact_time = persist_read_bool(key); break;
+      case PERSIST_KEY_THEME_MODE:        s_theme_mode = persist_read_int(key); break;
+      case PERSIST_KEY_CUSTOM_COLOR:      s_custom_color_index = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_USE_EMOJI:         s_use_emoji = persist_read_bool(key); break;
+      case PERSIST_KEY_BG_COLOR:          s_background_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_TIME_COLOR:        s_time_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_DATE_COLOR:        s_date_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_READINESS_COLOR:   s_readiness_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_SLEEP_COLOR:       s_sleep_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_HEART_COLOR:       s_heart_rate_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_ACTIVITY_COLOR:    s_activity_color = clamp_palette_index(persist_read_int(key)); break;
+      case PERSIST_KEY_STRESS_COLOR:      s_stress_color = clamp_palette_index(persist_read_int(key)); break;
+    }
+    persist_delete(key);
+  }
+  if (migrated) {
+    APP_LOG(APP_LOG_LEVEL_INFO, "Migrated per-key settings to settings blob");
+  }
+}
+
+static void load_settings(void) {
+  SettingsBlob blob;
+  int read = persist_read_data(PERSIST_KEY_SETTINGS, &blob, sizeof(blob));
+  if (read == (int)sizeof(blob) && blob.version == SETTINGS_BLOB_VERSION) {
+    unpack_settings(&blob);
+    s_settings_saved = blob;
+  } else {
+    // No blob yet (or an unknown version): start from defaults plus any legacy keys
+    migrate_legacy_settings();
+    memset(&s_settings_saved, 0, sizeof(s_settings_saved));
+  }
+  if (s_refresh_frequency_minutes < 1) s_refresh_frequency_minutes = 30;
+  if (s_settings_saved.version != SETTINGS_BLOB_VERSION) {
+    flush_settings();
+  }
+}
+
+// =============================================================================
+// METRICS PACKET (binary payload from JavaScript)
+// =============================================================================
+// All metrics arrive in one byte-array tuple (MESSAGE_KEY_metrics_packet).
+// Layout v1, little-endian (must match encodeMetricsPacket in src/pkjs/index.js):
+//   0  u8   version
+//   1  u8   availability bits (METRIC_BIT_*)
+//   2  u32  data date as YYYYMMDD
+//   6  i16  resting_heart_rate      8  i16  hrv_score
+//  10  i16  readiness_score        12  i16  temperature_deviation
+//  14  i16  recovery_index         16  i16  sleep_score
+//  18  i16  total_sleep_time       20  i16  deep_sleep_time
+//  22  i16  activity_score         24  i16  active_calories
+//  26  i32  steps                  30  i32  stress_duration
+//  34  i32  stress_high_duration   38  u32  last_updated (unix seconds)
+// Layout v2 appends:
+//  42  u8   fetched sources (METRIC_BIT_*); only these groups carry new values
+//  43  u8   optional: fetched sources whose record is from an earlier day than
+//           the data date (a yesterday fallback); shown but kept out of history
+// Each source's fields are one contiguous range, so a partial packet is merged
+// into the last full one group by group. The merged packet is kept as v1.
+
+#define METRICS_PACKET_VERSION          1
+#define METRICS_PACKET_VERSION_PARTIAL  2
+#define METRICS_PACKET_V1_SIZE          42
+#define METRICS_PACKET_V2_SIZE          43
+#define METRICS_PACKET_V2_EARLIER_SIZE  44
+
+#define METRIC_BIT_HEART_RATE    (1 << METRIC_SOURCE_HEART_RATE)
+#define METRIC_BIT_READINESS     (1 << METRIC_SOURCE_READINESS)
+#define METRIC_BIT_SLEEP         (1 << METRIC_SOURCE_SLEEP)
+#define METRIC_BIT_ACTIVITY      (1 << METRIC_SOURCE_ACTIVITY)
+#define METRIC_BIT_STRESS        (1 << METRIC_SOURCE_STRESS)
+
+// Byte range of each source's fields: [k_source_packet_offset[s], k_source_packet_offset[s + 1])
+static const uint8_t k_source_packet_offset[METRIC_SOURCE_COUNT + 1] = { 6, 10, 16, 22, 30, 38 };
+
+static uint32_t s_metrics_data_date = 0;   // YYYYMMDD of the last packet
+static time_t s_metrics_updated_at = 0;    // phone-side fetch time of the last packet
+
+static int16_t read_le16(const uint8_t *p) {
+  return (int16_t)(p[0] | (p[1] << 8));
+}
+
+static int32_t read_le32(const uint8_t *p) {
+  return (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                   ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+}
+
+// Decode a validated v1 packet straight into the Oura data structs
+static void decode_metrics_bytes(const uint8_t *p) {
+  uint8_t available = p[1];
+  s_metrics_data_date = (uint32_t)read_le32(p + 2);
+  
+  s_heart_rate_data.resting_heart_rate = read_le16(p + 6);
+  s_heart_rate_data.hrv_score = read_le16(p + 8);
+  s_heart_rate_data.data_available = (available & METRIC_BIT_HEART_RATE) != 0;
+  
+  s_readiness_data.readiness_score = read_le16(p + 10);
+  s_readiness_data.temperature_deviation = read_le16(p + 12);
+  s_readiness_data.recovery_index = read_le16(p + 14);
+  s_readiness_data.data_available = (available & METRIC_BIT_READINESS) != 0;
+  
+  s_sleep_data.sleep_score = read_le16(p + 16);
+  s_sleep_data.total_sleep_time = read_le16(p + 18);
+  s_sleep_data.deep_sleep_time = read_le16(p + 20);
+  s_sleep_data.data_available = (available & METRIC_BIT_SLEEP) != 0;
+  
+  s_activity_data.activity_score = read_le16(p + 22);
+  s_activity_data.active_calories = read_le16(p + 24);
+  s_activity_data.steps = read_le32(p + 26);
+  s_activity_data.data_available = (available & METRIC_BIT_ACTIVITY) != 0;
+  
+  s_stress_data.stress_duration = read_le32(p + 30);
+  s_stress_data.stress_high_duration = read_le32(p + 34);
+  s_stress_data.data_available = (available & METRIC_BIT_STRESS) != 0;
+  
+  s_metrics_updated_at = (time_t)(uint32_t)read_le32(p + 38);
+  
+  APP_LOG(APP_LOG_LEVEL_INFO, "Metrics packet v%d for %lu: avail=0x%02x HR=%d RDY=%d SLP=%d ACT=%d STR=%ds",
+          p[0], (unsigned long)s_metrics_data_date, available,
+          s_heart_rate_data.resting_heart_rate, s_readiness_data.readiness_score,
+          s_sleep_data.sleep_score, s_activity_data.activity_score, s_stress_data.stress_duration);
+}
+
+// -----------------------------------------------------------------------------
+// Last-known snapshot: the most recent packet is kept in persistent storage so
+// a relaunch can draw real values immediately (marked stale) while the phone
+// refresh runs in the background.
+// -----------------------------------------------------------------------------
+
+#define PERSIST_KEY_METRICS_SNAPSHOT    3001
+// Bytes compared to decide whether the snapshot needs rewriting; the trailing
+// last_updated stamp alone changes on every refresh and is not worth a write
+#define METRICS_SNAPSHOT_COMPARE_SIZE   (METRICS_PACKET_V1_SIZE - 4)
+
+// The merged packet plus per-source freshness; an older, smaller snapshot
+// fails the size check and is simply refetched.
+typedef struct __attribute__((__packed__)) {
+  uint32_t received_at;                   // watch time the packet arrived
+  uint8_t packet[METRICS_PACKET_V1_SIZE]; // merged, always v1 layout
+  uint32_t source_updated_at[METRIC_SOURCE_COUNT];
+  uint32_t source_data_date[METRIC_SOURCE_COUNT];
+} MetricsSnapshot;
+
+static MetricsSnapshot s_metrics_snapshot;
+
+// Persist only when values or source dates changed; fetch times alone are not
+// worth a flash write (losing them just makes the next request ask for more)
+static void save_metrics_snapshot(bool changed) {
+  s_metrics_snapshot.received_at = (uint32_t)time(NULL);
+  memcpy(s_metrics_snapshot.source_updated_at, s_source_updated_at, sizeof(s_source_updated_at));
+  if (memcmp(s_metrics_snapshot.source_data_date, s_source_data_date, sizeof(s_source_data_date)) != 0) {
+    memcpy(s_metrics_snapshot.source_data_date, s_source_data_date, sizeof(s_source_data_date));
+    changed = true;
+  }
+  if (changed) {
+    persist_write_data(PERSIST_KEY_METRICS_SNAPSHOT, &s_metrics_snapshot, sizeof(s_metrics_snapshot));
+  }
+}
+
+static void load_metrics_snapshot(void) {
+  int read = persist_read_data(PERSIST_KEY_METRICS_SNAPSHOT, &s_metrics_snapshot, sizeof(s_metrics_snapshot));
+  if (read != (int)sizeof(s_metrics_snapshot) || s_metrics_snapshot.packet[0] != METRICS_PACKET_VERSION) {
+    memset(&s_metrics_snapshot, 0, sizeof(s_metrics_snapshot));
+    return;
+  }
+  decode_metrics_bytes(s_metrics_snapshot.packet);
+  memcpy(s_source_updated_at, s_metrics_snapshot.source_updated_at, sizeof(s_source_updated_at));
+  memcpy(s_source_data_date, s_metrics_snapshot.source_data_date, sizeof(s_source_data_date));
+  s_metrics_received_at = (time_t)s_metrics_snapshot.received_at;
+  s_metrics_stale = true;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Loaded metrics snapshot from %lu", (unsigned long)s_metrics_snapshot.received_at);
+}
+
+// Fold the fetched groups of an incoming packet into the snapshot packet.
+// Returns whether anything besides the last_updated stamp changed.
+static bool merge_metrics_packet(const uint8_t *p, uint8_t fetched) {
+  uint8_t *merged = s_metrics_snapshot.packet;
+  uint8_t before[METRICS_SNAPSHOT_COMPARE_SIZE];
+  bool had_packet = merged[0] == METRICS_PACKET_VERSION;
+  memcpy(before, merged, sizeof(before));
+  
+  if (!had_packet) {
+    memcpy(merged, p, METRICS_PACKET_V1_SIZE);  // unfetched groups arrive empty
+  } else {
+    memcpy(merged + 2, p + 2, 4);               // data date
+    memcpy(merged + 38, p + 38, 4);             // last_updated
+    for (int source = 0; source < METRIC_SOURCE_COUNT; source++) {
+      if (fetched & (1 << source)) {
+        uint8_t start = k_source_packet_offset[source];
+        memcpy(merged + start, p + start, k_source_packet_offset[source + 1] - start);
+      }
+    }
+  }
+  merged[0] = METRICS_PACKET_VERSION;
+  merged[1] = (uint8_t)((merged[1] & ~fetched) | (p[1] & fetched));
+  
+  uint32_t now = (uint32_t)time(NULL);
+  uint32_t date = (uint32_t)read_le32(p + 2);
+  for (int source = 0; source < METRIC_SOURCE_COUNT; source++) {
+    if (fetched & (1 << source)) {
+      s_source_updated_at[source] = now;
+      s_source_data_date[source] = date;
+    }
+  }
+  return !had_packet || memcmp(before, merged, sizeof(before)) != 0;
+}
+
+// Decode a metrics packet tuple from the phone; returns the sources it
+// updated (0 = nothing merged)
+static uint8_t decode_metrics_packet(const Tuple *t) {
+  if (t->type != TUPLE_BYTE_ARRAY || t->length < 1) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Metrics packet: unexpected tuple type %d", (int)t->type);
+    return 0;
+  }
+  const uint8_t *p = t->value->data;
+  uint8_t fetched;
+  uint8_t earlier = 0;
+  if (p[0] == METRICS_PACKET_VERSION && t->length >= METRICS_PACKET_V1_SIZE) {
+    fetched = METRIC_SOURCE_ALL;  // full packet
+  } else if (p[0] == METRICS_PACKET_VERSION_PARTIAL && t->length >= METRICS_PACKET_V2_SIZE) {
+    fetched = p[METRICS_PACKET_V1_SIZE] & METRIC_SOURCE_ALL;
+    if (t->length >= METRICS_PACKET_V2_EARLIER_SIZE) {
+      earlier = p[METRICS_PACKET_V2_SIZE] & fetched;
+    }
+  } else {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Metrics packet: unsupported version %d (%d bytes)", p[0], t->length);
+    return 0;
+  }
+  if (!fetched) {
+    // Nothing fetched in this message (e.g. a completion whose metrics went out
+    // in earlier updates): keep values and freshness
+    APP_LOG(APP_LOG_LEVEL_INFO, "Metrics packet carries no fetched sources");
+    return 0;
+  }
+  bool changed = merge_metrics_packet(p, fetched);
+  decode_metrics_bytes(s_metrics_snapshot.packet);
+  save_metrics_snapshot(changed);
+  // A yesterday fallback would land in today's slot
+  update_metric_history(s_metrics_data_date, fetched & ~earlier);
+  s_metrics_received_at = time(NULL);
+  s_metrics_stale = false;
+  update_stale_indicators(s_metrics_received_at);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Metrics merged: fetched=0x%02x", fetched);
+  return fetched;
+}
+
 // =============================================================================
 // APPMESSAGE HANDLERS (Communication with JavaScript)
 // =============================================================================
 
+// Helper: the C-string in a tuple, or NULL if it is not NUL-terminated within its length
+static const char *tuple_cstring(const Tuple *t) {
+  if (t->type != TUPLE_CSTRING || t->length == 0 || t->value->cstring[t->length - 1] != '\0') {
+    return NULL;
+  }
+  return t->value->cstring;
+}
+
 // Helper: convert a tuple that may be an int or a numeric string to int
 static int tuple_to_int(const Tuple *t, int fallback) {
-  if (!t || !t->value) {
+  if (!t) {
     return fallback;
   }
   // If we received a C-string, parse it (config page sometimes sends numeric strings)
-  if (t->type == TUPLE_CSTRING && t->value->cstring) {
-    const char *s = t->value->cstring;
+  if (t->type == TUPLE_CSTRING) {
+    const char *s = tuple_cstring(t);
     // Use atoi; if non-numeric, it returns 0, which is acceptable for our palette indices
-    return atoi(s);
+    return s ? atoi(s) : fallback;
+  }
+  // Integers arrive as 1, 2 or 4 bytes depending on the sender; byte arrays are not numbers
+  bool is_signed = t->type == TUPLE_INT;
+  if (t->type != TUPLE_INT && t->type != TUPLE_UINT) {
+    return fallback;
+  }
+  switch (t->length) {
+    case 1: return is_signed ? t->value->int8 : t->value->uint8;
+    case 2: return is_signed ? t->value->int16 : t->value->uint16;
+    case 4: return t->value->int32;
+    default: return fallback;
   }
-  // Otherwise, prefer int32
-  return t->value->int32;
 }
 
 // Helper: convert tuple to boolean, accepting 1/0 and "true"/"false" strings
 static bool tuple_to_bool(const Tuple *t, bool fallback) {
-  if (!t || !t->value) {
+  if (!t) {
     return fallback;
   }
-  if (t->type == TUPLE_CSTRING && t->value->cstring) {
-    const char *s = t->value->cstring;
+  if (t->type == TUPLE_CSTRING) {
+    const char *s = tuple_cstring(t);
+    if (!s) return fallback;
     // Check first character to avoid heavy libc calls
     if (s[0] == '1' || s[0] == 't' || s[0] == 'T' || s[0] == 'y' || s[0] == 'Y') return true;
     if (s[0] == '0' || s[0] == 'f' || s[0] == 'F' || s[0] == 'n' || s[0] == 'N') return false;
     // Fallback to atoi
     return atoi(s) != 0;
   }
-  return t->value->int32 != 0;
+  return tuple_to_int(t, fallback ? 1 : 0) != 0;
 }
 
-static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
-  APP_LOG(APP_LOG_LEVEL_INFO, "Message received from phone");
-  
-  // Handle debug status messages
-  Tuple *debug_tuple = dict_find(iterator, MESSAGE_KEY_debug_status);
-  if (debug_tuple) {
-    update_debug_display(debug_tuple->value->cstring);
+// -----------------------------------------------------------------------------
+// Inbox dispatch: one dict_read_first/dict_read_next walk over the message,
+// each tuple routed through a key -> handler table. Handlers only update state
+// and collect effects; persistence and re-rendering run once per message.
+// -----------------------------------------------------------------------------
+
+// Effects collected while walking one message
+#define INBOX_EFFECT_CLOCK      (1 << 0)  // time/date text needs re-rendering
+#define INBOX_EFFECT_TICKS      (1 << 1)  // tick subscription changed
+#define INBOX_EFFECT_COMPLETE   (1 << 2)  // payload_complete received
+
+typedef struct {
+  bool settings_changed;      // a persisted setting changed value
+  uint8_t render;             // RENDER_DIRTY_* flags
+  uint16_t measurements;      // measurement types to re-format
+  uint8_t effects;            // INBOX_EFFECT_*
+  uint8_t fetched;            // sources a metrics packet in this message updated
+  uint8_t layout_seen;        // bit 0-2: left/middle/right, bit 3: rows, bit 4-5: row2 left/right
+  int layout[6];              // pending layout values, indexed like layout_seen
+} InboxEffects;
+
+typedef enum {
+  SETTING_CUSTOM = 0,         // no stored setting
+  SETTING_INT,                // int setting stored in target
+  SETTING_BOOL,               // bool setting stored in target
+  SETTING_PALETTE             // palette index stored in target, clamped to the palette
+} SettingKind;
+
+typedef void (*InboxTupleHandler)(const Tuple *t, int entry_index, InboxEffects *fx);
+
+typedef struct InboxKeyHandler {
+  const uint32_t *key;        // &MESSAGE_KEY_x (message keys are link-time values)
+  InboxTupleHandler handler;  // NULL for plain settings
+  SettingKind kind;
+  void *target;
+  bool persisted;             // stored in the settings blob
+  uint8_t render;             // RENDER_DIRTY_* raised when the setting changes
+  uint8_t effects;            // INBOX_EFFECT_* raised when the setting changes
+  const char *name;           // for logging
+} InboxKeyHandler;
+
+static void handle_debug_status(const Tuple *t, int entry_index, InboxEffects *fx) {
+  const char *message = tuple_cstring(t);
+  if (message) {
+    update_debug_display(message);
   }
-  
-  // Process heart rate data
-  Tuple *heart_rate_tuple = dict_find(iterator, MESSAGE_KEY_heart_rate);
-  if (heart_rate_tuple) {
-    Tuple *hr_value = dict_find(iterator, MESSAGE_KEY_resting_heart_rate);
-    Tuple *hrv_value = dict_find(iterator, MESSAGE_KEY_hrv_score);
-    Tuple *hr_available = dict_find(iterator, MESSAGE_KEY_data_available);
-    
-    if (hr_value && hrv_value && hr_available) {
-      s_heart_rate_data.resting_heart_rate = hr_value->value->int32;
-      s_heart_rate_data.hrv_score = hrv_value->value->int32;
-      s_heart_rate_data.data_available = hr_available->value->int32 == 1;
-      update_heart_rate_display();
-      APP_LOG(APP_LOG_LEVEL_INFO, "Heart rate updated: %d bpm", s_heart_rate_data.resting_heart_rate);
-    }
+}
+
+static void handle_metrics_packet(const Tuple *t, int entry_index, InboxEffects *fx) {
+  fx->fetched |= decode_metrics_packet(t);
+  if (fx->fetched) {
+    fx->measurements = (1 << MEASUREMENT_TYPE_COUNT) - 1;
   }
-  
-  // Process readiness data
-  Tuple *readiness_tuple = dict_find(iterator, MESSAGE_KEY_readiness);
-  if (readiness_tuple) {
-    Tuple *score_value = dict_find(iterator, MESSAGE_KEY_readiness_score);
-    Tuple *temp_deviation_value = dict_find(iterator, MESSAGE_KEY_temperature_deviation);
-    Tuple *recovery_value = dict_find(iterator, MESSAGE_KEY_recovery_index);
-    Tuple *rdy_available = dict_find(iterator, MESSAGE_KEY_data_available);
-    
-    if (score_value && temp_deviation_value && recovery_value && rdy_available) {
-      s_readiness_data.readiness_score = score_value->value->int32;
-      s_readiness_data.temperature_deviation = temp_deviation_value->value->int32;
-      s_readiness_data.recovery_index = recovery_value->value->int32;
-      s_readiness_data.data_available = rdy_available->value->int32 == 1;
-      update_readiness_display();
-      APP_LOG(APP_LOG_LEVEL_INFO, "Readiness updated: %d score, recovery: %d", 
-              s_readiness_data.readiness_score, s_readiness_data.recovery_index);
-    }
+}
+
+static void handle_payload_complete(const Tuple *t, int entry_index, InboxEffects *fx) {
+  fx->effects |= INBOX_EFFECT_COMPLETE;
+}
+
+// Layout keys are applied together at the end of the message (see apply_inbox_layout)
+static void handle_layout_key(const Tuple *t, int slot, InboxEffects *fx) {
+  fx->layout_seen |= (uint8_t)(1 << slot);
+  fx->layout[slot] = tuple_to_int(t, 0);
+}
+static void handle_layout_left(const Tuple *t, int entry_index, InboxEffects *fx) { handle_layout_key(t, 0, fx); }
+static void handle_layout_middle(const Tuple *t, int entry_index, InboxEffects *fx) { handle_layout_key(t, 1, fx); }
+static void handle_layout_right(const Tuple *t, int entry_index, InboxEffects *fx) { handle_layout_key(t, 2, fx); }
+static void handle_layout_rows(const Tuple *t, int entry_index, InboxEffects *fx) { handle_layout_key(t, 3, fx); }
+static void handle_row2_left(const Tuple *t, int entry_index, InboxEffects *fx) { handle_layout_key(t, 4, fx); }
+static void handle_row2_right(const Tuple *t, int entry_index, InboxEffects *fx) { handle_layout_key(t, 5, fx); }
+
+static void handle_show_loading(const Tuple *t, int entry_index, InboxEffects *fx) {
+  bool show_loading = tuple_to_bool(t, s_show_loading);
+  s_initial_startup = false; // Initial startup complete, now respect user preference
+  if (show_loading == s_show_loading) {
+    return;
   }
-  
-  // Process sleep data
-  Tuple *sleep_tuple = dict_find(iterator, MESSAGE_KEY_sleep);
-  if (sleep_tuple) {
-    Tuple *sleep_score_value = dict_find(iterator, MESSAGE_KEY_sleep_score);
-    Tuple *total_sleep_value = dict_find(iterator, MESSAGE_KEY_total_sleep_time);
-    Tuple *deep_sleep_value = dict_find(iterator, MESSAGE_KEY_deep_sleep_time);
-    Tuple *sleep_available = dict_find(iterator, MESSAGE_KEY_data_available);
-    
-    if (sleep_score_value && total_sleep_value && deep_sleep_value && sleep_available) {
-      s_sleep_data.sleep_score = sleep_score_value->value->int32;
-      s_sleep_data.total_sleep_time = total_sleep_value->value->int32;
-      s_sleep_data.deep_sleep_time = deep_sleep_value->value->int32;
-      s_sleep_data.data_available = sleep_available->value->int32 == 1;
-      update_sleep_display();
-      APP_LOG(APP_LOG_LEVEL_INFO, "Sleep updated: %d score, %d min total", 
-              s_sleep_data.sleep_score, s_sleep_data.total_sleep_time);
-    }
+  s_show_loading = show_loading;
+  fx->settings_changed = true;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Show loading overlay setting: %d (initial startup complete)", s_show_loading);
+}
+
+static void handle_refresh_frequency(const Tuple *t, int entry_index, InboxEffects *fx) {
+  int new_freq = clamp_refresh_frequency(tuple_to_int(t, s_refresh_frequency_minutes));
+  if (new_freq == s_refresh_frequency_minutes) {
+    return;
   }
-  
-  // Process activity data (use struct + display helper for "--" when unavailable)
-  Tuple *activity_score_tuple = dict_find(iterator, MESSAGE_KEY_activity_score);
-  if (activity_score_tuple) {
-    int activity_score = activity_score_tuple->value->int32;
-    s_activity_data.activity_score = activity_score;
-    // Optional extras if present
-    Tuple *active_calories_tuple = dict_find(iterator, MESSAGE_KEY_active_calories);
-    if (active_calories_tuple) {
-      s_activity_data.active_calories = active_calories_tuple->value->int32;
-    }
-    Tuple *steps_tuple = dict_find(iterator, MESSAGE_KEY_steps);
-    if (steps_tuple) {
-      s_activity_data.steps = steps_tuple->value->int32;
+  s_refresh_frequency_minutes = new_freq;
+  s_minutes_since_refresh = 0; // Restart counter on change
+  fx->settings_changed = true;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Refresh frequency updated: %d minutes", s_refresh_frequency_minutes);
+}
+
+static const InboxKeyHandler s_inbox_handlers[] = {
+  { &MESSAGE_KEY_debug_status,       handle_debug_status,       SETTING_CUSTOM, NULL,                          false, 0,                    0, "debug_status" },
+  { &MESSAGE_KEY_metrics_packet,     handle_metrics_packet,     SETTING_CUSTOM, NULL,                          false, 0,                    0, "metrics_packet" },
+  { &MESSAGE_KEY_payload_complete,   handle_payload_complete,   SETTING_CUSTOM, NULL,                          false, 0,                    0, "payload_complete" },
+  { &MESSAGE_KEY_layout_left,        handle_layout_left,        SETTING_CUSTOM, NULL,                          false, 0,                    0, "layout_left" },
+  { &MESSAGE_KEY_layout_middle,      handle_layout_middle,      SETTING_CUSTOM, NULL,                          false, 0,                    0, "layout_middle" },
+  { &MESSAGE_KEY_layout_right,       handle_layout_right,       SETTING_CUSTOM, NULL,                          false, 0,                    0, "layout_right" },
+  { &MESSAGE_KEY_layout_rows,        handle_layout_rows,        SETTING_CUSTOM, NULL,                          false, 0,                    0, "layout_rows" },
+  { &MESSAGE_KEY_row2_left,          handle_row2_left,          SETTING_CUSTOM, NULL,                          false, 0,                    0, "row2_left" },
+  { &MESSAGE_KEY_row2_right,         handle_row2_right,         SETTING_CUSTOM, NULL,                          false, 0,                    0, "row2_right" },
+  // The settings page restore path uses the layout_row2_* names
+  { &MESSAGE_KEY_layout_row2_left,   handle_row2_left,          SETTING_CUSTOM, NULL,                          false, 0,                    0, "layout_row2_left" },
+  { &MESSAGE_KEY_layout_row2_right,  handle_row2_right,         SETTING_CUSTOM, NULL,                          false, 0,                    0, "layout_row2_right" },
+  { &MESSAGE_KEY_show_loading,       handle_show_loading,       SETTING_BOOL,   &s_show_loading,               true,  0,                    0, "show_loading" },
+  { &MESSAGE_KEY_refresh_frequency,  handle_refresh_frequency,  SETTING_INT,    &s_refresh_frequency_minutes,  true,  0,                    0, "refresh_frequency" },
+  { &MESSAGE_KEY_use_emoji,          NULL,                      SETTING_BOOL,   &s_use_emoji,                  true,  RENDER_DIRTY_METRICS, 0, "use_emoji" },
+  { &MESSAGE_KEY_background_color,   NULL,                      SETTING_PALETTE, &s_background_color,           true,  RENDER_DIRTY_THEME,   0, "background_color" },
+  { &MESSAGE_KEY_time_color,         NULL,                      SETTING_PALETTE, &s_time_color,                 true,  RENDER_DIRTY_THEME,   0, "time_color" },
+  { &MESSAGE_KEY_date_color,         NULL,                      SETTING_PALETTE, &s_date_color,                 true,  RENDER_DIRTY_THEME,   0, "date_color" },
+  { &MESSAGE_KEY_readiness_color,    NULL,                      SETTING_PALETTE, &s_readiness_color,            true,  RENDER_DIRTY_THEME,   0, "readiness_color" },
+  { &MESSAGE_KEY_sleep_color,        NULL,                      SETTING_PALETTE, &s_sleep_color,                true,  RENDER_DIRTY_THEME,   0, "sleep_color" },
+  { &MESSAGE_KEY_heart_rate_color,   NULL,                      SETTING_PALETTE, &s_heart_rate_color,           true,  RENDER_DIRTY_THEME,   0, "heart_rate_color" },
+  { &MESSAGE_KEY_activity_color,     NULL,                      SETTING_PALETTE, &s_activity_color,             true,  RENDER_DIRTY_THEME,   0, "activity_color" },
+  { &MESSAGE_KEY_stress_color,       NULL,                      SETTING_PALETTE, &s_stress_color,               true,  RENDER_DIRTY_THEME,   0, "stress_color" },
+  { &MESSAGE_KEY_theme_mode,         NULL,                      SETTING_INT,    &s_theme_mode,                 true,  RENDER_DIRTY_THEME,   0, "theme_mode" },
+  { &MESSAGE_KEY_custom_color_index, NULL,                      SETTING_PALETTE, &s_custom_color_index,         true,  RENDER_DIRTY_THEME,   0, "custom_color_index" },
+  { &MESSAGE_KEY_date_format,        NULL,                      SETTING_INT,    &s_date_format,                false, 0,                    INBOX_EFFECT_CLOCK, "date_format" },
+  { &MESSAGE_KEY_show_seconds,       NULL,                      SETTING_BOOL,   &s_show_seconds,               true,  0,                    INBOX_EFFECT_TICKS | INBOX_EFFECT_CLOCK, "show_seconds" },
+  { &MESSAGE_KEY_compact_time,       NULL,                      SETTING_BOOL,   &s_compact_time,               true,  0,                    INBOX_EFFECT_CLOCK, "compact_time" },
+  { &MESSAGE_KEY_show_debug,         NULL,                      SETTING_BOOL,   &s_show_debug,                 true,  0,                    0, "show_debug" },
+};
+#define INBOX_HANDLER_COUNT ((int)(sizeof(s_inbox_handlers) / sizeof(s_inbox_handlers[0])))
+
+// Dense key -> handler lookup. AppMessage keys are assigned consecutively, so
+// the span is small; entries hold handler index + 1 (0 = unhandled key).
+#define INBOX_DISPATCH_MAX_SPAN 96
+static uint8_t s_inbox_slots[INBOX_DISPATCH_MAX_SPAN];
+static uint32_t s_inbox_key_base = 0;
+static bool s_inbox_dense = false;
+
+static void build_inbox_dispatch(void) {
+  uint32_t min_key = UINT32_MAX;
+  uint32_t max_key = 0;
+  for (int i = 0; i < INBOX_HANDLER_COUNT; i++) {
+    uint32_t key = *s_inbox_handlers[i].key;
+    if (key < min_key) min_key = key;
+    if (key > max_key) max_key = key;
+  }
+  s_inbox_key_base = min_key;
+  s_inbox_dense = (max_key - min_key) < INBOX_DISPATCH_MAX_SPAN;
+  memset(s_inbox_slots, 0, sizeof(s_inbox_slots));
+  if (s_inbox_dense) {
+    for (int i = 0; i < INBOX_HANDLER_COUNT; i++) {
+      s_inbox_slots[*s_inbox_handlers[i].key - min_key] = (uint8_t)(i + 1);
     }
-    // Infer availability: any positive field indicates availability
-    s_activity_data.data_available = (s_activity_data.activity_score > 0) ||
-                                     (s_activity_data.active_calories > 0) ||
-                                     (s_activity_data.steps > 0);
-    update_activity_display();
-    APP_LOG(APP_LOG_LEVEL_INFO, "Activity updated: %d score (available=%d)", activity_score, s_activity_data.data_available);
+  } else {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Inbox keys span %lu, using linear dispatch",
+            (unsigned long)(max_key - min_key));
   }
-  
-  // Process stress data (use struct + display helper for "--" when 0/unavailable)
-  Tuple *stress_duration_tuple = dict_find(iterator, MESSAGE_KEY_stress_duration);
-  if (stress_duration_tuple) {
-    int stress_seconds = stress_duration_tuple->value->int32;
-    s_stress_data.stress_duration = stress_seconds;
-    Tuple *stress_high_tuple = dict_find(iterator, MESSAGE_KEY_stress_high_duration);
-    if (stress_high_tuple) {
-      s_stress_data.stress_high_duration = stress_high_tuple->value->int32;
+}
+
+static int find_inbox_handler(uint32_t key) {
+  if (s_inbox_dense) {
+    uint32_t offset = key - s_inbox_key_base;
+    return (key >= s_inbox_key_base && offset < INBOX_DISPATCH_MAX_SPAN) ? s_inbox_slots[offset] - 1 : -1;
+  }
+  for (int i = 0; i < INBOX_HANDLER_COUNT; i++) {
+    if (*s_inbox_handlers[i].key == key) return i;
+  }
+  return -1;
+}
+
+// Plain int/bool settings: store, then raise the entry's persist/render/effect
+// bits if the value actually changed (the phone resends unchanged settings)
+static void apply_setting_tuple(const Tuple *t, int entry_index, InboxEffects *fx) {
+  const InboxKeyHandler *entry = &s_inbox_handlers[entry_index];
+  bool changed;
+  if (entry->kind == SETTING_BOOL) {
+    bool *target = (bool *)entry->target;
+    bool value = tuple_to_bool(t, *target);
+    changed = value != *target;
+    *target = value;
+  } else {
+    int *target = (int *)entry->target;
+    int value = tuple_to_int(t, *target);
+    if (entry->kind == SETTING_PALETTE) {
+      value = clamp_palette_index(value);
     }
-    // Consider stress available if we received the tuple, even if 0 seconds
-    s_stress_data.data_available = true;
-    update_stress_display();
-    APP_LOG(APP_LOG_LEVEL_INFO, "Stress updated: %ds (available=%d)", stress_seconds, s_stress_data.data_available);
+    changed = value != *target;
+    *target = value;
   }
-  
-  // Process layout configuration
-  Tuple *layout_left_tuple = dict_find(iterator, MESSAGE_KEY_layout_left);
-  Tuple *layout_middle_tuple = dict_find(iterator, MESSAGE_KEY_layout_middle);
-  Tuple *layout_right_tuple = dict_find(iterator, MESSAGE_KEY_layout_right);
-  
-  if (layout_left_tuple && layout_middle_tuple && layout_right_tuple) {
-    s_layout_left = layout_left_tuple->value->int32;
-    s_layout_middle = layout_middle_tuple->value->int32;
-    s_layout_right = layout_right_tuple->value->int32;
-    
+  if (!changed) {
+    return;
+  }
+  APP_LOG(APP_LOG_LEVEL_INFO, "Setting %s updated", entry->name);
+  if (entry->persisted) {
+    fx->settings_changed = true;
+  }
+  fx->render |= entry->render;
+  fx->effects |= entry->effects;
+}
+
+// Apply layout keys collected during the walk (same grouping rules as before)
+static void apply_inbox_layout(InboxEffects *fx) {
+  if ((fx->layout_seen & 0x07) == 0x07) {
+    s_layout_left = fx->layout[0];
+    s_layout_middle = fx->layout[1];
+    s_layout_right = fx->layout[2];
     APP_LOG(APP_LOG_LEVEL_INFO, "Layout config updated: L=%d M=%d R=%d", 
             s_layout_left, s_layout_middle, s_layout_right);
-    
-    // Update all displays to reflect new layout
-    update_heart_rate_display();
-    update_readiness_display();
-    update_sleep_display();
+    fx->render |= RENDER_DIRTY_METRICS;
   }
-  
-  // Process flexible layout configuration (row 2 support)
-  Tuple *layout_rows_tuple = dict_find(iterator, MESSAGE_KEY_layout_rows);
-  Tuple *row2_left_tuple = dict_find(iterator, MESSAGE_KEY_row2_left);
-  Tuple *row2_right_tuple = dict_find(iterator, MESSAGE_KEY_row2_right);
-  
-  if (layout_rows_tuple) {
-    s_layout_rows = layout_rows_tuple->value->int32;
+  if (fx->layout_seen & 0x08) {
+    s_layout_rows = fx->layout[3];
     APP_LOG(APP_LOG_LEVEL_INFO, "Layout rows updated: %d", s_layout_rows);
-    
-    if (row2_left_tuple && row2_right_tuple) {
-      s_layout_row2_left = row2_left_tuple->value->int32;
-      s_layout_row2_right = row2_right_tuple->value->int32;
-      
+    if ((fx->layout_seen & 0x30) == 0x30) {
+      s_layout_row2_left = fx->layout[4];
+      s_layout_row2_right = fx->layout[5];
       APP_LOG(APP_LOG_LEVEL_INFO, "Row 2 config updated: L=%d R=%d", 
               s_layout_row2_left, s_layout_row2_right);
     }
-    
-    // Apply dynamic layout positioning based on row count
-    apply_dynamic_layout_positioning();
-    
-    // Update all displays to reflect new layout (including row positioning)
-    update_heart_rate_display();
-    update_readiness_display();
-    update_sleep_display();
-    update_activity_display();
-    update_stress_display();
-  }
-  
-  // Process individual color configuration
-  Tuple *use_emoji_tuple = dict_find(iterator, MESSAGE_KEY_use_emoji);
-  if (use_emoji_tuple) {
-    s_use_emoji = tuple_to_bool(use_emoji_tuple, s_use_emoji);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Emoji mode updated: %s", s_use_emoji ? "enabled" : "disabled");
-    persist_write_bool(PERSIST_KEY_USE_EMOJI, s_use_emoji);
-    // Immediately refresh labels to reflect emoji/text change
-    update_all_measurements();
-  }
-  
-  Tuple *background_color_tuple = dict_find(iterator, MESSAGE_KEY_background_color);
-  if (background_color_tuple) {
-    s_background_color = tuple_to_int(background_color_tuple, s_background_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Background color updated: %d", s_background_color);
-    persist_write_int(PERSIST_KEY_BG_COLOR, s_background_color);
-  }
-  
-  Tuple *time_color_tuple = dict_find(iterator, MESSAGE_KEY_time_color);
-  if (time_color_tuple) {
-    s_time_color = tuple_to_int(time_color_tuple, s_time_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Time color updated: %d", s_time_color);
-    persist_write_int(PERSIST_KEY_TIME_COLOR, s_time_color);
-  }
-  
-  Tuple *date_color_tuple = dict_find(iterator, MESSAGE_KEY_date_color);
-  if (date_color_tuple) {
-    s_date_color = tuple_to_int(date_color_tuple, s_date_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Date color updated: %d", s_date_color);
-    persist_write_int(PERSIST_KEY_DATE_COLOR, s_date_color);
-  }
-  
-  Tuple *readiness_color_tuple = dict_find(iterator, MESSAGE_KEY_readiness_color);
-  if (readiness_color_tuple) {
-    s_readiness_color = tuple_to_int(readiness_color_tuple, s_readiness_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Readiness color updated: %d", s_readiness_color);
-    persist_write_int(PERSIST_KEY_READINESS_COLOR, s_readiness_color);
-  }
-  
-  Tuple *sleep_color_tuple = dict_find(iterator, MESSAGE_KEY_sleep_color);
-  if (sleep_color_tuple) {
-    s_sleep_color = tuple_to_int(sleep_color_tuple, s_sleep_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Sleep color updated: %d", s_sleep_color);
-    persist_write_int(PERSIST_KEY_SLEEP_COLOR, s_sleep_color);
-  }
-  
-  Tuple *heart_rate_color_tuple = dict_find(iterator, MESSAGE_KEY_heart_rate_color);
-  if (heart_rate_color_tuple) {
-    s_heart_rate_color = tuple_to_int(heart_rate_color_tuple, s_heart_rate_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Heart rate color updated: %d", s_heart_rate_color);
-    persist_write_int(PERSIST_KEY_HEART_COLOR, s_heart_rate_color);
-  }
-  
-  Tuple *activity_color_tuple = dict_find(iterator, MESSAGE_KEY_activity_color);
-  if (activity_color_tuple) {
-    s_activity_color = tuple_to_int(activity_color_tuple, s_activity_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Activity color updated: %d", s_activity_color);
-    persist_write_int(PERSIST_KEY_ACTIVITY_COLOR, s_activity_color);
-  }
-  
-  Tuple *stress_color_tuple = dict_find(iterator, MESSAGE_KEY_stress_color);
-  if (stress_color_tuple) {
-    s_stress_color = tuple_to_int(stress_color_tuple, s_stress_color);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Stress color updated: %d", s_stress_color);
-    persist_write_int(PERSIST_KEY_STRESS_COLOR, s_stress_color);
-  }
-  
-  // Apply colors if any color settings were received
-  if (background_color_tuple || time_color_tuple || date_color_tuple || 
-      readiness_color_tuple || sleep_color_tuple || heart_rate_color_tuple ||
-      activity_color_tuple || stress_color_tuple) {
-    apply_theme_colors();
+    // Apply dynamic layout positioning based on row count, then refill all cells
+    fx->render |= RENDER_DIRTY_LAYOUT | RENDER_DIRTY_METRICS;
   }
+}
 
-  // Process date format configuration
-  Tuple *date_format_tuple = dict_find(iterator, MESSAGE_KEY_date_format);
-  if (date_format_tuple) {
-    s_date_format = tuple_to_int(date_format_tuple, s_date_format);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Date format updated: %d", s_date_format);
-    update_date_display();
-  }
-  
-  // Process theme mode configuration
-  Tuple *theme_mode_tuple = dict_find(iterator, MESSAGE_KEY_theme_mode);
-  if (theme_mode_tuple) {
-    s_theme_mode = tuple_to_int(theme_mode_tuple, s_theme_mode);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Theme mode updated: %d", s_theme_mode);
-    persist_write_int(PERSIST_KEY_THEME_MODE, s_theme_mode);
-    apply_theme_colors();
-  }
-  
-  // Process custom color index (for theme mode 2)
-  Tuple *custom_color_tuple = dict_find(iterator, MESSAGE_KEY_custom_color_index);
-  if (custom_color_tuple) {
-    s_custom_color_index = tuple_to_int(custom_color_tuple, s_custom_color_index);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Custom color index updated: %d", s_custom_color_index);
-    persist_write_int(PERSIST_KEY_CUSTOM_COLOR, s_custom_color_index);
-    if (s_theme_mode == 2) {
-      apply_theme_colors();
-      APP_LOG(APP_LOG_LEVEL_INFO, "Custom color applied to watchface");
+static uint8_t s_payload_fetched = 0;  // sources updated since the last payload_complete
+
+static void inbox_received_callback(DictionaryIterator *iterator, void *context) {
+  APP_LOG(APP_LOG_LEVEL_INFO, "Message received from phone");
+  s_render_stats.messages++;
+  
+  // Single pass over the message
+  InboxEffects fx;
+  memset(&fx, 0, sizeof(fx));
+  for (Tuple *t = dict_read_first(iterator); t; t = dict_read_next(iterator)) {
+    int index = find_inbox_handler(t->key);
+    if (index < 0) {
+      continue; // Not for the watchface (auth keys etc.)
+    }
+    const InboxKeyHandler *entry = &s_inbox_handlers[index];
+    if (entry->handler) {
+      entry->handler(t, index, &fx);
+    } else {
+      apply_setting_tuple(t, index, &fx);
     }
   }
-
-  // Process show loading screen configuration
-  Tuple *show_loading_tuple = dict_find(iterator, MESSAGE_KEY_show_loading);
-  if (show_loading_tuple) {
-    s_show_loading = tuple_to_bool(show_loading_tuple, s_show_loading);
-    s_initial_startup = false; // Initial startup complete, now respect user preference
-    persist_write_bool(PERSIST_KEY_SHOW_LOADING, s_show_loading);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Show loading overlay setting: %d (initial startup complete)", s_show_loading);
+  
+  // Side effects, once per message
+  apply_inbox_layout(&fx);
+  if (fx.settings_changed) {
+    schedule_settings_flush();
+    release_disabled_layers();
   }
-
-  // Process show seconds configuration
-  Tuple *show_seconds_tuple = dict_find(iterator, MESSAGE_KEY_show_seconds);
-  if (show_seconds_tuple) {
-    s_show_seconds = tuple_to_bool(show_seconds_tuple, s_show_seconds);
-    persist_write_bool(PERSIST_KEY_SHOW_SECONDS, s_show_seconds);
+  if (fx.effects & INBOX_EFFECT_TICKS) {
     update_tick_subscription();
-    update_time_display();
-    APP_LOG(APP_LOG_LEVEL_INFO, "Show Seconds setting updated: %d", s_show_seconds);
   }
-
-  // Process compact time configuration
-  Tuple *compact_time_tuple = dict_find(iterator, MESSAGE_KEY_compact_time);
-  if (compact_time_tuple) {
-    s_compact_time = tuple_to_bool(compact_time_tuple, s_compact_time);
-    persist_write_bool(PERSIST_KEY_COMPACT_TIME, s_compact_time);
-    update_time_display();
-    APP_LOG(APP_LOG_LEVEL_INFO, "Compact Time setting updated: %d", s_compact_time);
+  if (fx.effects & INBOX_EFFECT_CLOCK) {
+    refresh_clock();
+  }
+  // A stream's last message may carry no metrics of its own
+  s_payload_fetched |= fx.fetched;
+  if (fx.effects & INBOX_EFFECT_COMPLETE) {
+    request_finish(true, NULL);
+    if (s_payload_fetched) {
+      // Payloads the phone started itself (new token from the config page)
+      // count too, whatever state our own request is in
+      refresh_note_success();
+    }
+    s_payload_fetched = 0;
+    if (!s_fetch_completed) {
+      // Missing values switch from blank to "--" now that the fetch finished
+      s_fetch_completed = true;
+      fx.measurements = (1 << MEASUREMENT_TYPE_COUNT) - 1;
+    }
   }
-
-  // Process show debug preference
-  Tuple *show_debug_tuple = dict_find(iterator, MESSAGE_KEY_show_debug);
-  if (show_debug_tuple) {
-    s_show_debug = tuple_to_bool(show_debug_tuple, s_show_debug);
-    persist_write_bool(PERSIST_KEY_SHOW_DEBUG, s_show_debug);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Show debug setting updated: %d", s_show_debug);
+  if (fx.measurements) {
+    s_measurement_dirty |= fx.measurements;
+    fx.render |= RENDER_DIRTY_METRICS;
   }
-
-  // Process refresh frequency (minutes)
-  Tuple *refresh_freq_tuple = dict_find(iterator, MESSAGE_KEY_refresh_frequency);
-  if (refresh_freq_tuple) {
-    int new_freq = tuple_to_int(refresh_freq_tuple, s_refresh_frequency_minutes);
-    if (new_freq < 1) new_freq = 1; // Safety guard
-    s_refresh_frequency_minutes = new_freq;
-    s_minutes_since_refresh = 0; // Restart counter on change
-    persist_write_int(PERSIST_KEY_REFRESH_FREQUENCY, s_refresh_frequency_minutes);
-    APP_LOG(APP_LOG_LEVEL_INFO, "Refresh frequency updated: %d minutes", s_refresh_frequency_minutes);
+  if (fx.render) {
+    request_render(fx.render);
   }
   
   // If we received any real data, hide the sample indicator
@@ -1435,9 +2900,7 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
   
   // Mark that real data was received and clear debug message after 10 seconds
   s_real_data_received = true;
-  Tuple *payload_complete_tuple = dict_find(iterator, MESSAGE_KEY_payload_complete);
-  if (payload_complete_tuple) {
-    s_fetch_completed = true;
+  if (fx.effects & INBOX_EFFECT_COMPLETE) {
     // Always hide loading screen when data arrives, regardless of how it was shown
     if (s_loading) {
       // Hold loading screen for 2 seconds to allow reading logs
@@ -1449,6 +2912,11 @@ static void inbox_received_callback(DictionaryIterator *iterator, void *context)
     app_timer_cancel(s_debug_timer);
   }
   s_debug_timer = app_timer_register(10000, debug_timer_callback, NULL);
+  
+  // The phone is talking now: send a request that could not reach it earlier
+  if (s_refresh_catch_up && s_phone_connected && s_request_state == REQUEST_IDLE) {
+    refresh_now();
+  }
 }
 
 static void inbox_dropped_callback(AppMessageResult reason, void *context) {
@@ -1457,76 +2925,42 @@ static void inbox_dropped_callback(AppMessageResult reason, void *context) {
 
 static void outbox_failed_callback(DictionaryIterator *iterator, AppMessageResult reason, void *context) {
   APP_LOG(APP_LOG_LEVEL_ERROR, "Outbox send failed: %d", reason);
+  if (request_is_active_message(iterator)) {
+    request_finish(false, "outbox failed");
+    // Usually PebbleKit JS not running yet (launch): retry on its first message
+    s_refresh_catch_up = true;
+  }
 }
 
 static void outbox_sent_callback(DictionaryIterator *iterator, void *context) {
   APP_LOG(APP_LOG_LEVEL_INFO, "Outbox send success");
+  if (request_is_active_message(iterator)) {
+    // Phone has the request; now waiting for payload_complete
+    s_request_state = REQUEST_AWAITING_PAYLOAD;
+  }
 }
 
 // Apply theme colors to all UI elements
 static void apply_theme_colors(void) {
+  resolve_theme();
+  
   // Update window background
   if (s_window) {
-    window_set_background_color(s_window, get_palette_color(s_background_color));
-  }
-  
-  // Update time and date with individual colors
-  if (s_time_layer) {
-    text_layer_set_text_color(s_time_layer, get_palette_color(s_time_color));
-  }
-  
-  if (s_date_layer) {
-    text_layer_set_text_color(s_date_layer, get_palette_color(s_date_color));
-  }
-  
-  // Keep debug and sample indicator using time color for consistency
-  if (s_debug_layer) {
-    text_layer_set_text_color(s_debug_layer, get_palette_color(s_time_color));
-  }
-  
-  if (s_sample_indicator_layer) {
-    text_layer_set_text_color(s_sample_indicator_layer, get_palette_color(s_time_color));
-  }
-  
-  // Update measurement layers with individual colors
-  if (s_sleep_layer) {
-    text_layer_set_text_color(s_sleep_layer, get_palette_color(s_sleep_color));
-  }
-  
-  if (s_sleep_label_layer) {
-    text_layer_set_text_color(s_sleep_label_layer, get_palette_color(s_sleep_color));
-  }
-  
-  if (s_readiness_layer) {
-    text_layer_set_text_color(s_readiness_layer, get_palette_color(s_readiness_color));
-  }
-  
-  if (s_readiness_label_layer) {
-    text_layer_set_text_color(s_readiness_label_layer, get_palette_color(s_readiness_color));
-  }
-  
-  if (s_heart_rate_layer) {
-    text_layer_set_text_color(s_heart_rate_layer, get_palette_color(s_heart_rate_color));
+    window_set_background_color(s_window, s_theme.background);
   }
   
-  if (s_heart_rate_label_layer) {
-    text_layer_set_text_color(s_heart_rate_label_layer, get_palette_color(s_heart_rate_color));
-  }
-  
-  if (s_activity_layer) {
-    text_layer_set_text_color(s_activity_layer, get_palette_color(s_activity_color));
-  }
-  
-  if (s_activity_label_layer) {
-    text_layer_set_text_color(s_activity_label_layer, get_palette_color(s_activity_color));
-  }
+  // Time, seconds, debug and sample indicator share the time color; date has its own
+  if (s_time_layer) text_layer_set_text_color(s_time_layer, s_theme.time);
+  if (s_seconds_layer) text_layer_set_text_color(s_seconds_layer, s_theme.time);
+  if (s_date_layer) text_layer_set_text_color(s_date_layer, s_theme.date);
+  if (s_sample_indicator_layer) text_layer_set_text_color(s_sample_indicator_layer, s_theme.time);
   
-  if (s_stress_layer) {
-    text_layer_set_text_color(s_stress_layer, get_palette_color(s_stress_color));
+  // Metric cells follow the color of the measurement they show
+  for (int i = 0; i < METRIC_CELL_COUNT; i++) {
+    s_metric_cells[i].color = get_measurement_color(s_metric_cells[i].measurement);
   }
-  
-  if (s_stress_label_layer) {
-    text_layer_set_text_color(s_stress_label_layer, get_palette_color(s_stress_color));
+  if (s_metrics_layer) {
+    layer_mark_dirty(s_metrics_layer);
   }
 }
 
@@ -1534,6 +2968,12 @@ static void apply_theme_colors(void) {
 // APP LIFECYCLE
 // =============================================================================
 
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+static void unobstructed_area_did_change(void *context) {
+  request_render(RENDER_DIRTY_LAYOUT | RENDER_DIRTY_METRICS);
+}
+#endif
+
 static void init(void) {
   // Create main window
   s_window = window_create();
@@ -1544,77 +2984,44 @@ static void init(void) {
   window_stack_push(s_window, true);
   
   // Initialize AppMessage for communication with JavaScript
+  build_inbox_dispatch();
   app_message_register_inbox_received(inbox_received_callback);
   app_message_register_inbox_dropped(inbox_dropped_callback);
   app_message_register_outbox_failed(outbox_failed_callback);
   app_message_register_outbox_sent(outbox_sent_callback);
   
-  // Open AppMessage with appropriate buffer sizes
-  const int inbox_size = 512;
+  // Open AppMessage with appropriate buffer sizes (metrics arrive as one compact packet)
+  const int inbox_size = 256;
   const int outbox_size = 64;
   app_message_open(inbox_size, outbox_size);
 
-  // Load persisted preferences
-  if (persist_exists(PERSIST_KEY_SHOW_LOADING)) {
-    s_show_loading = persist_read_bool(PERSIST_KEY_SHOW_LOADING);
-  }
-  if (persist_exists(PERSIST_KEY_SHOW_DEBUG)) {
-    s_show_debug = persist_read_bool(PERSIST_KEY_SHOW_DEBUG);
-  }
-  if (persist_exists(PERSIST_KEY_REFRESH_FREQUENCY)) {
-    s_refresh_frequency_minutes = persist_read_int(PERSIST_KEY_REFRESH_FREQUENCY);
-  }
-  if (persist_exists(PERSIST_KEY_SHOW_SECONDS)) {
-    s_show_seconds = persist_read_bool(PERSIST_KEY_SHOW_SECONDS);
-  }
-  if (persist_exists(PERSIST_KEY_COMPACT_TIME)) {
-    s_compact_time = persist_read_bool(PERSIST_KEY_COMPACT_TIME);
-  }
-  // Load persisted theme/color preferences
-  if (persist_exists(PERSIST_KEY_THEME_MODE)) {
-    s_theme_mode = persist_read_int(PERSIST_KEY_THEME_MODE);
-  }
-  if (persist_exists(PERSIST_KEY_CUSTOM_COLOR)) {
-    s_custom_color_index = persist_read_int(PERSIST_KEY_CUSTOM_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_USE_EMOJI)) {
-    s_use_emoji = persist_read_bool(PERSIST_KEY_USE_EMOJI);
-  }
-  if (persist_exists(PERSIST_KEY_BG_COLOR)) {
-    s_background_color = persist_read_int(PERSIST_KEY_BG_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_TIME_COLOR)) {
-    s_time_color = persist_read_int(PERSIST_KEY_TIME_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_DATE_COLOR)) {
-    s_date_color = persist_read_int(PERSIST_KEY_DATE_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_READINESS_COLOR)) {
-    s_readiness_color = persist_read_int(PERSIST_KEY_READINESS_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_SLEEP_COLOR)) {
-    s_sleep_color = persist_read_int(PERSIST_KEY_SLEEP_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_HEART_COLOR)) {
-    s_heart_rate_color = persist_read_int(PERSIST_KEY_HEART_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_ACTIVITY_COLOR)) {
-    s_activity_color = persist_read_int(PERSIST_KEY_ACTIVITY_COLOR);
-  }
-  if (persist_exists(PERSIST_KEY_STRESS_COLOR)) {
-    s_stress_color = persist_read_int(PERSIST_KEY_STRESS_COLOR);
-  }
-  if (s_refresh_frequency_minutes < 1) s_refresh_frequency_minutes = 30;
+  // Load persisted preferences (single settings blob)
+  load_settings();
+  // Last-known values so the face is populated before the phone answers
+  load_metrics_snapshot();
+  load_metric_history();
+  local_health_init();
   s_minutes_since_refresh = 0;
   
   // Initialize displays
-  update_time_display();
+  refresh_clock();
   // Apply persisted theme/colors after layers are created
   apply_theme_colors();
-  fetch_oura_data();
+  // Draw the snapshot right away; the request goes out now or on reconnect
+  mark_all_measurements_dirty();
+  update_sample_indicator();
+  refresh_scheduler_init();
+  refresh_now();
   
   // Subscribe to time updates
   update_tick_subscription();
+
+#if PBL_API_EXISTS(unobstructed_area_service_subscribe)
+  // Timeline Quick View: re-layout once the obstruction settles
+  unobstructed_area_service_subscribe((UnobstructedAreaHandlers) {
+    .did_change = unobstructed_area_did_change
+  }, NULL);
+#endif
   
   // Initialize custom color mode
   if (s_theme_mode == 2) {
@@ -1625,6 +3032,8 @@ static void init(void) {
 }
 
 static void deinit(void) {
+  local_health_deinit();
+  flush_settings();
   window_destroy(s_window);
 }
 
@@ -1632,4 +3041,5 @@ int main(void) {
   init();
   app_event_loop();
   deinit();
+  return 0;
 }
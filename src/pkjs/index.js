@@ -23,13 +23,21 @@ var WATCH_DEBUG = false; // do not spam watch debug layer unless explicitly enab
 // -----------------------------------------------------------------------------
 var MSG_MAX_RETRIES = 3;
 var MSG_RETRY_DELAY_MS = 250; // short backoff
-var ACTIVITY_SEND_DELAY_MS = 1000; // delay aggregated send slightly
 var g_msg_queue = [];
 var g_msg_sending = false;
 
 function enqueueMessage(payload, onSuccess, onError) {
-  g_msg_queue.push({ payload: payload, tries: 0, onSuccess: onSuccess, onError: onError });
+  var item = { payload: payload, tries: 0, onSuccess: onSuccess, onError: onError };
+  g_msg_queue.push(item);
   processMessageQueue();
+  return item;
+}
+
+// True while a queued item has not been handed to sendAppMessage yet (a failed
+// head item waiting for its retry counts: the retry re-reads item.payload)
+function isMessagePending(item) {
+  var index = item ? g_msg_queue.indexOf(item) : -1;
+  return index > 0 || (index === 0 && !g_msg_sending);
 }
 
 function processMessageQueue() {
@@ -59,58 +67,6 @@ function processMessageQueue() {
   });
 }
 
-// Cache management
-var CACHE_VERSION = 'v1';
-
-// Global cache variables
-var g_cached_sleep_score = 0;
-var g_cached_readiness_score = 0;
-var g_cache_date = '';
-
-var CACHE_KEYS = {
-  READINESS: CACHE_VERSION + '_readiness',
-  SLEEP: CACHE_VERSION + '_sleep',
-  TIMESTAMP: CACHE_VERSION + '_timestamp'
-};
-
-// Cache functions
-function getCachedData(key) {
-  try {
-    var data = localStorage.getItem(key);
-    return data ? JSON.parse(data) : null;
-  } catch (e) {
-    console.log('Cache read error:', e);
-    return null;
-  }
-}
-
-function setCachedData(key, data) {
-  try {
-    localStorage.setItem(key, JSON.stringify(data));
-    localStorage.setItem(CACHE_KEYS.TIMESTAMP, Date.now());
-  } catch (e) {
-    console.log('Cache write error:', e);
-  }
-}
-
-function updateCacheIfValid(key, newValue) {
-  if (!newValue) return false;
-  
-  var currentValue = getCachedData(key);
-  // Only update if new value is valid (non-zero)
-  if (newValue && newValue !== '0' && newValue !== 0) {
-    setCachedData(key, newValue);
-    return true;
-  }
-  return false;
-}
-
-function getCachedValue(key) {
-  var cached = getCachedData(key);
-  // Return cached value if it exists and is valid
-  return (cached && cached !== '0' && cached !== 0) ? cached : null;
-}
-
 // OAuth2 configuration - SECURE CLIENT-SIDE-ONLY FLOW
 // No client secret stored in browser - uses Oura's official client-side-only flow
 var OURA_CONFIG = {
@@ -123,8 +79,7 @@ var OURA_CONFIG = {
 var STORAGE_KEYS = {
   ACCESS_TOKEN: 'oura_access_token',
   REFRESH_TOKEN: 'oura_refresh_token',
-  TOKEN_EXPIRES: 'oura_token_expires',
-  LAST_UPDATE: 'oura_last_update'
+  TOKEN_EXPIRES: 'oura_token_expires'
 };
 
 // Global variables
@@ -133,12 +88,6 @@ var g_api_completion_count = 0;
 var g_total_apis = 3;
 var g_aggregated_data = {};
 
-// Persistent score cache to solve 0-0-65 problem
-var g_cached_sleep_score = 0;
-var g_cached_readiness_score = 0;
-var g_cached_activity_score = 0;
-var g_cache_date = null;
-
 // Helper function to get local date string (YYYY-MM-DD) instead of UTC
 // Compatible with older JavaScript environments (no padStart)
 function getLocalDateString() {
@@ -184,104 +133,285 @@ function getYesterdayDate() {
   return year + '-' + monthStr + '-' + dayStr;
 }
 
-// Load cached values from localStorage on startup
-function loadCachedScores() {
+// =============================================================================
+// PHONE STATE (write-behind)
+// =============================================================================
+// Everything this script persists lives in one object under STATE_KEY: the
+// watch settings from the config page, the score cache and the per-day
+// record store. It is read from localStorage once (at
+// `ready`), accessed in memory, and written back by flushState() once per
+// refresh cycle or config change, only when something changed. Tokens stay
+// in their own keys because the config and setup pages write them directly.
+
+var STATE_KEY = 'oura_state';
+var STATE_SCHEMA = 3; // 2 was the last oura_cached_scores layout
+
+// Settings and their types; getSetting() returns the default when unset
+var STATE_SETTINGS = {
+  date_format:        { type: 'int',  def: null },
+  theme_mode:         { type: 'int',  def: null },
+  refresh_frequency:  { type: 'int',  def: null },
+  show_loading:       { type: 'bool', def: false },
+  show_seconds:       { type: 'bool', def: false },
+  compact_time:       { type: 'bool', def: false },
+  use_emoji:          { type: 'bool', def: false },
+  show_debug:         { type: 'bool', def: true },
+  measurement_layout: { type: 'json', def: null },
+  custom_color:       { type: 'json', def: null },
+  background_color:   { type: 'int',  def: null },
+  time_color:         { type: 'int',  def: null },
+  date_color:         { type: 'int',  def: null },
+  readiness_color:    { type: 'int',  def: null },
+  sleep_color:        { type: 'int',  def: null },
+  heart_rate_color:   { type: 'int',  def: null },
+  activity_color:     { type: 'int',  def: null },
+  stress_color:       { type: 'int',  def: null }
+};
+
+// Keys the state replaced; read once for migration, then removed
+var LEGACY_STATE_KEYS = ['oura_cached_scores', 'oura_cache_schema', 'oura_day_records',
+  'oura_last_update', 'oura_config_settings', 'v1_readiness', 'v1_sleep', 'v1_timestamp'];
+
+var g_state = null;
+var g_state_dirty = false;
+var g_state_migrated = false; // legacy keys are removed by the next flush
+
+function emptyState() {
+  return {
+    schema: STATE_SCHEMA,
+    settings: {},
+    // cache_date is shared by readiness and sleep; activity carries its own
+    scores: { readiness: 0, sleep: 0, activity: 0, activity_date: null, cache_date: null },
+    day_records: {}
+  };
+}
+
+// Typed value for a setting, or undefined when `raw` does not convert
+function coerceSetting(name, raw) {
+  var type = STATE_SETTINGS[name].type;
+  if (raw === null || raw === undefined || raw === '') return undefined;
+  if (type === 'bool') {
+    return raw === true || raw === 1 || raw === '1' || raw === 'true';
+  }
+  if (type === 'int') {
+    var n = parseInt(raw, 10);
+    return isNaN(n) ? undefined : n;
+  }
+  if (typeof raw === 'string') {
+    try { return JSON.parse(raw); } catch (e) { return undefined; }
+  }
+  return raw;
+}
+
+// Build state from the per-setting oura_* keys and the old score cache
+function migrateLegacyState() {
+  var state = emptyState();
+  for (var name in STATE_SETTINGS) {
+    if (STATE_SETTINGS.hasOwnProperty(name)) {
+      var value = coerceSetting(name, localStorage.getItem('oura_' + name));
+      if (value !== undefined) state.settings[name] = value;
+    }
+  }
   try {
-    var today = getLocalDateString();
-    // One-time cache schema migration to purge stale activity caches
-    var schema = localStorage.getItem('oura_cache_schema');
-    if (schema !== '2') {
-      console.log('Migrating cache schema to v2: purging old oura_cached_scores');
-      localStorage.removeItem('oura_cached_scores');
-      localStorage.setItem('oura_cache_schema', '2');
+    var cached = localStorage.getItem('oura_cache_schema') === '2' ?
+      JSON.parse(localStorage.getItem('oura_cached_scores') || 'null') : null;
+    if (cached) {
+      state.scores.readiness = parseInt(cached.readiness_score, 10) || 0;
+      state.scores.sleep = parseInt(cached.sleep_score, 10) || 0;
+      state.scores.activity = parseInt(cached.activity_score, 10) || 0;
+      state.scores.activity_date = cached.activity_date || null;
+      state.scores.cache_date = cached.cache_date || null;
     }
-    var cachedData = localStorage.getItem('oura_cached_scores');
-    
-    if (cachedData) {
-      var data = JSON.parse(cachedData);
-      console.log('Raw cached data:', data);
-      
-      // Only use cached data if it's from today
-      if (data.cache_date === today) {
-        if (data.sleep_score) {
-          g_cached_sleep_score = parseInt(data.sleep_score);
-          console.log('Loaded cached sleep score:', g_cached_sleep_score);
-        }
+    var days = JSON.parse(localStorage.getItem('oura_day_records') || 'null');
+    if (days && days.collections) state.day_records = days.collections;
+  } catch (e) {
+    console.warn('Legacy cache unreadable, dropping it:', e);
+  }
+  return state;
+}
 
-        if (data.readiness_score) {
-          g_cached_readiness_score = parseInt(data.readiness_score);
-          console.log('Loaded cached readiness score:', g_cached_readiness_score);
-        }
-        // Only load activity if activity_date matches today
-        if (data.activity_score && data.activity_date === today) {
-          g_cached_activity_score = parseInt(data.activity_score);
-          console.log('Loaded cached activity score for today:', g_cached_activity_score);
-        } else if (data.activity_score) {
-          console.log('Cached activity score date mismatch or missing activity_date, ignoring activity cache');
-        }
-        g_cache_date = data.cache_date;
-      } else {
-        console.log('Cached data is from a different date, ignoring and clearing in-memory cached scores');
-        // Clear in-memory cached values to avoid reusing stale scores
-        g_cached_sleep_score = 0;
-        g_cached_readiness_score = 0;
-        g_cached_activity_score = 0;
-        g_cache_date = null;
-      }
-    } else {
-      console.log('No cached scores found in localStorage');
-    }
+function loadState() {
+  var state = null;
+  try {
+    state = JSON.parse(localStorage.getItem(STATE_KEY) || 'null');
   } catch (e) {
-    console.error('Error loading cached scores:', e);
+    console.warn('State unreadable, starting fresh:', e);
   }
+  if (state && state.schema === STATE_SCHEMA) {
+    g_state = state;
+  } else if (state) {
+    // Cached data from another schema is dropped; settings carry over
+    console.log('Phone state schema', state.schema, '->', STATE_SCHEMA);
+    g_state = emptyState();
+    g_state.settings = state.settings || {};
+    g_state_dirty = true;
+  } else {
+    console.log('Migrating legacy localStorage keys to phone state');
+    g_state = migrateLegacyState();
+    g_state_dirty = true;
+    g_state_migrated = true;
+  }
+  // Scores only carry over within the day they were cached
+  var today = getLocalDateString();
+  var scores = g_state.scores;
+  if (scores.cache_date !== today && (scores.readiness || scores.sleep)) {
+    console.log('Cached scores are from', scores.cache_date, '- ignoring them');
+    scores.readiness = 0;
+    scores.sleep = 0;
+    scores.cache_date = null;
+    g_state_dirty = true;
+  }
+  return g_state;
 }
 
-// Save cached scores to localStorage - only saves if values are valid (non-zero)
-function saveCachedScores() {
+function state() {
+  return g_state || loadState();
+}
+
+// Write the state back if anything changed since the last flush
+function flushState() {
+  if (!g_state_dirty) return;
   try {
-    var today = getLocalDateString();
-    // Start with existing cache if present to avoid clobbering unrelated fields
-    var existingRaw = localStorage.getItem('oura_cached_scores');
-    var data = {};
-    if (existingRaw) {
-      try {
-        data = JSON.parse(existingRaw) || {};
-      } catch (e) {
-        console.warn('Failed to parse existing cache, starting fresh');
-        data = {};
+    localStorage.setItem(STATE_KEY, JSON.stringify(state()));
+    g_state_dirty = false;
+    if (g_state_migrated) {
+      g_state_migrated = false;
+      for (var i = 0; i < LEGACY_STATE_KEYS.length; i++) {
+        localStorage.removeItem(LEGACY_STATE_KEYS[i]);
+      }
+      for (var name in STATE_SETTINGS) {
+        if (STATE_SETTINGS.hasOwnProperty(name)) localStorage.removeItem('oura_' + name);
       }
     }
+  } catch (e) {
+    console.error('Error saving phone state:', e);
+  }
+}
 
-    // Always update sleep and readiness from current values
-    data.sleep_score = g_cached_sleep_score;
-    data.readiness_score = g_cached_readiness_score;
+function getSetting(name) {
+  var value = state().settings[name];
+  return value === undefined ? STATE_SETTINGS[name].def : value;
+}
 
-    // Only update activity fields when we have an intentional activity update
-    if (g_cached_activity_score > 0 && g_cache_date) {
-      data.activity_score = g_cached_activity_score;
-      data.activity_date = g_cache_date;
-      console.log('Saving activity with date:', g_cache_date, 'score:', g_cached_activity_score);
-    } else {
-      console.log('Preserving existing activity in cache:', data.activity_date, data.activity_score);
-    }
+function setSetting(name, raw) {
+  var value = coerceSetting(name, raw);
+  if (value === undefined) return;
+  state().settings[name] = value;
+  g_state_dirty = true;
+}
 
-    // Cache-wide date for sleep/readiness; keep most recent cache date
-    data.cache_date = g_cache_date || today;
-    
-    console.log('Saving cached scores:', data);
-    localStorage.setItem('oura_cached_scores', JSON.stringify(data));
-    console.log('Successfully saved cached scores to localStorage');
-    
-    // Debug: Verify the data was saved correctly
-    var verify = localStorage.getItem('oura_cached_scores');
-    console.log('Verification read from localStorage:', verify);
-  } catch (e) {
-    console.error('Error saving cached scores:', e);
+// Cached score for 'readiness', 'sleep' or 'activity' (0 when none); the
+// activity score only counts on the day it was cached
+function getCachedScore(metric) {
+  var scores = state().scores;
+  if (metric === 'activity' && scores.activity_date !== getLocalDateString()) return 0;
+  return scores[metric] || 0;
+}
+
+function getCachedScoreDate() {
+  return state().scores.cache_date;
+}
+
+function setCachedScore(metric, score, day) {
+  var scores = state().scores;
+  scores[metric] = score;
+  scores.cache_date = day;
+  if (metric === 'activity') scores.activity_date = day;
+  g_state_dirty = true;
+}
+
+// =============================================================================
+// PER-DAY RECORD STORE
+// =============================================================================
+// Daily records kept in the phone state by (collection, day), trimmed to the
+// fields the watch uses. A final day is never requested again:
+//   - readiness and sleep: once the day has a score
+//   - any past day: once it was fetched DAY_FINAL_GRACE_MS after it ended
+//     (the ring has synced by then, so activity and stress totals are complete)
+// Days that were requested but came back empty are stored as { empty: true }
+// so they can become final too. Only the last DAY_STORE_KEEP_DAYS are kept.
+
+var DAY_STORE_KEEP_DAYS = 7;
+var DAY_FINAL_GRACE_MS = 12 * 60 * 60 * 1000;
+var DAY_RECORD_FIELDS = {
+  daily_readiness: ['score', 'temperature_deviation', 'recovery_index'],
+  daily_sleep: ['score'],
+  daily_activity: ['score', 'active_calories', 'steps'],
+  daily_stress: ['stress_high'],
+  // Sleep periods (seconds, ms); a day keeps its longest period, the main sleep
+  sleep: ['total_sleep_duration', 'deep_sleep_duration', 'average_hrv']
+};
+// Field that makes a day final as soon as it is non-zero
+var DAY_FINAL_FIELD = { daily_readiness: 'score', daily_sleep: 'score', sleep: 'total_sleep_duration' };
+
+// collection -> day -> { at, rec }
+function dayStore() {
+  return state().day_records;
+}
+
+// Local midnight ending a YYYY-MM-DD day
+function dayEndTime(day) {
+  var parts = day.split('-');
+  return new Date(parseInt(parts[0], 10), parseInt(parts[1], 10) - 1, parseInt(parts[2], 10) + 1).getTime();
+}
+
+function trimDayRecord(collection, rec) {
+  var fields = DAY_RECORD_FIELDS[collection] || [];
+  var trimmed = { day: rec.day };
+  for (var i = 0; i < fields.length; i++) {
+    trimmed[fields[i]] = rec[fields[i]];
   }
+  if (collection === 'daily_readiness' && !trimmed.recovery_index) {
+    trimmed.recovery_index = (rec.contributors && rec.contributors.recovery_index) || 0;
+  }
+  return trimmed;
 }
 
-// Initialize cache
-loadCachedScores();
+function dayStoreIsFinal(collection, day) {
+  var entry = (dayStore()[collection] || {})[day];
+  if (!entry) return false;
+  var field = DAY_FINAL_FIELD[collection];
+  if (field && (entry.rec[field] || 0) > 0) return true;
+  return entry.at >= dayEndTime(day) + DAY_FINAL_GRACE_MS;
+}
+
+// Stored records for the given days (missing days are skipped)
+function dayStoreRecords(collection, days) {
+  var entries = dayStore()[collection] || {};
+  var records = [];
+  for (var i = 0; i < days.length; i++) {
+    if (entries[days[i]]) records.push(entries[days[i]].rec);
+  }
+  return records;
+}
+
+// Record a response covering `days`; days without a record are stored as empty
+function dayStoreUpdate(collection, days, records) {
+  var store = dayStore();
+  var entries = store[collection] || (store[collection] = {});
+  var now = Date.now();
+  for (var i = 0; i < days.length; i++) {
+    entries[days[i]] = { at: now, rec: { day: days[i], empty: true } };
+  }
+  var seen = {};
+  for (var r = 0; records && r < records.length; r++) {
+    var rec = records[r];
+    if (!rec || !rec.day) continue;
+    // Several sleep periods can share a day (naps, rest): keep the longest
+    if (seen[rec.day] && (rec.total_sleep_duration || 0) < (entries[rec.day].rec.total_sleep_duration || 0)) continue;
+    seen[rec.day] = true;
+    entries[rec.day] = { at: now, rec: trimDayRecord(collection, rec) };
+  }
+  // Drop days that fell out of the window
+  var cutoff = new Date();
+  cutoff.setDate(cutoff.getDate() - DAY_STORE_KEEP_DAYS);
+  var oldest = cutoff.getFullYear() + '-' + (cutoff.getMonth() < 9 ? '0' : '') + (cutoff.getMonth() + 1) +
+    '-' + (cutoff.getDate() < 10 ? '0' : '') + cutoff.getDate();
+  for (var day in entries) {
+    if (entries.hasOwnProperty(day) && day < oldest) delete entries[day];
+  }
+  g_state_dirty = true;
+}
 
 // =============================================================================
 // OAUTH2 AUTHENTICATION
@@ -399,6 +529,8 @@ function makeOuraRequest(endpoint, token, callback) {
   }
   var startDate = params.start_date || null;
   var endDate = params.end_date || null;
+  var startDatetime = params.start_datetime || null;
+  var endDatetime = params.end_datetime || null;
   
   // Build proxy URL
   var proxyUrl = OURA_CONFIG.PROXY_URL + 
@@ -407,6 +539,8 @@ function makeOuraRequest(endpoint, token, callback) {
   
   if (startDate) proxyUrl += '&start_date=' + encodeURIComponent(startDate);
   if (endDate) proxyUrl += '&end_date=' + encodeURIComponent(endDate);
+  if (startDatetime) proxyUrl += '&start_datetime=' + encodeURIComponent(startDatetime);
+  if (endDatetime) proxyUrl += '&end_datetime=' + encodeURIComponent(endDatetime);
   
   console.log('[oura] 📡 Proxy URL:', proxyUrl.replace(token, token.substring(0, 10) + '...'));
   
@@ -452,618 +586,369 @@ function makeOuraRequest(endpoint, token, callback) {
   xhr.send();
 }
 
+// Last night's main sleep period: total and deep sleep for the sleep cell and
+// the average HRV for the heart rate cell. Both fetchers ask for it in the same
+// refresh, so a request in flight is shared. callback(period or null)
+var g_sleep_period_waiters = null;
+
+function hasSleepPeriod(rec) {
+  return (rec.total_sleep_duration || 0) > 0;
+}
+
+function fetchSleepPeriod(token, callback) {
+  if (g_sleep_period_waiters) {
+    g_sleep_period_waiters.push(callback);
+    return;
+  }
+  g_sleep_period_waiters = [callback];
+  fetchRecentDaily('sleep', token, hasSleepPeriod, function(error, record) {
+    if (error) {
+      console.error('Failed to fetch sleep periods:', error);
+    }
+    var waiters = g_sleep_period_waiters;
+    g_sleep_period_waiters = null;
+    for (var i = 0; i < waiters.length; i++) {
+      waiters[i](record || null);
+    }
+  });
+}
+
+// Heart rate is a 5-minute time series and by far the largest response, so
+// only a short trailing window is requested. An empty window (ring off the
+// finger, not yet synced) widens to the next step; the last step covers the
+// rest of the day like the old full-day query did.
+var HR_WINDOW_MINUTES = [30, 180, 24 * 60];
+
+// Latest sample with a bpm. Samples arrive oldest first, so scan from the tail
+// and stop at the first valid one instead of parsing every timestamp.
+function findLatestHeartRate(samples) {
+  for (var i = samples.length - 1; i >= 0; i--) {
+    var rec = samples[i];
+    if (rec && typeof rec.bpm === 'number') {
+      return rec;
+    }
+  }
+  return null;
+}
+
 function fetchHeartRateData(token, callback) {
-  var dataDate = getOuraDataDate(); // Use yesterday's date for Oura data
-  var endpoint = '/usercollection/heartrate?start_date=' + dataDate + '&end_date=' + dataDate;
+  var now = new Date();
+  var step = 0;
+  var result = null;
+  var period;   // undefined until the sleep period answers
   
-  console.log('[oura] Fetching heart rate data for:', dataDate);
   sendDebugStatus('Getting heart rate...');
   
-  makeOuraRequest(endpoint, token, function(error, data) {
-    if (error) {
-      console.error('Failed to fetch heart rate data:', error);
-      sendDebugStatus('HR API failed');
-      callback({ data_available: false });
-      return;
+  // HRV comes from last night's sleep, heart rate from the trailing window
+  function done() {
+    if (!result || period === undefined) return;
+    if (result.data_available) {
+      result.hrv_score = (period && period.average_hrv) || 0;
     }
+    callback(result);
+  }
+  
+  fetchSleepPeriod(token, function(p) {
+    period = p;
+    done();
+  });
+  
+  function tryWindow() {
+    var minutes = HR_WINDOW_MINUTES[step];
+    var start = new Date(now.getTime() - minutes * 60 * 1000);
+    var endpoint = '/usercollection/heartrate?start_datetime=' + encodeURIComponent(start.toISOString()) +
+      '&end_datetime=' + encodeURIComponent(now.toISOString());
     
-    if (data && data.data && data.data.length > 0) {
-      // Use the latest heart rate sample of the day (most recent timestamp)
-      var latestIdx = -1;
-      var latestTs = 0;
-      var latestRmssd = 0;
-      for (var i = 0; i < data.data.length; i++) {
-        var rec = data.data[i];
-        if (!rec || typeof rec.bpm !== 'number') { continue; }
-        var t = 0;
-        if (rec.timestamp) {
-          var parsed = Date.parse(rec.timestamp);
-          if (!isNaN(parsed)) { t = parsed; }
-        }
-        // If timestamp missing/unparseable, prefer later items by index
-        if (t === 0) { t = i; }
-        if (t >= latestTs) {
-          latestTs = t;
-          latestIdx = i;
-          latestRmssd = (typeof rec.rmssd === 'number') ? rec.rmssd : latestRmssd;
+    console.log('[oura] Fetching heart rate for the last', minutes, 'minutes');
+    
+    makeOuraRequest(endpoint, token, function(error, data) {
+      if (error) {
+        console.error('Failed to fetch heart rate data:', error);
+        sendDebugStatus('HR API failed');
+        result = { data_available: false };
+        done();
+        return;
+      }
+      
+      var samples = (data && data.data) || [];
+      var latest = findLatestHeartRate(samples);
+      if (!latest) {
+        if (++step < HR_WINDOW_MINUTES.length) {
+          console.log('[oura] No HR samples in the last', minutes, 'minutes, widening');
+          tryWindow();
+          return;
         }
+        console.log('[oura] No heart rate data available');
+        sendDebugStatus('No HR data today');
+        result = { data_available: false };
+        done();
+        return;
       }
-      var latestBpm = (latestIdx >= 0) ? Math.round(data.data[latestIdx].bpm) : 0;
-      console.log('[oura] HR records:', data.data.length, 'latest bpm:', latestBpm, 'latest rmssd:', latestRmssd);
+      
+      var latestBpm = Math.round(latest.bpm);
+      console.log('[oura] HR records:', samples.length, 'latest bpm:', latestBpm, 'at', latest.timestamp);
       sendDebugStatus('HR latest: ' + latestBpm + ' bpm');
-      callback({
+      result = {
         resting_heart_rate: latestBpm,
-        hrv_score: latestRmssd || 0,
         data_available: true
-      });
-    } else {
-      console.log('[oura] No heart rate data available');
-      sendDebugStatus('No HR data today');
-      callback({ data_available: false });
+      };
+      done();
+    });
+  }
+  
+  tryWindow();
+}
+
+// Newest usable record for yesterday..today. Daily scores for today appear only
+// after the morning sync, so that is today's record when it exists and
+// yesterday's otherwise. Only days the store does not hold as final are
+// requested, in one ranged query; when every day is final there is no request.
+// A failed request still answers from the store when it can.
+// callback(error, record, todayDate)
+function fetchRecentDaily(collection, token, isValid, callback) {
+  var todayDate = getOuraDataDate();
+  var days = [getYesterdayDate(), todayDate];
+  var open = days.filter(function(day) { return !dayStoreIsFinal(collection, day); });
+  
+  function newestStored() {
+    return pickNewestRecord(dayStoreRecords(collection, days), isValid);
+  }
+  
+  if (!open.length) {
+    console.log('[oura]', collection, 'is final for', days.join(', '), '- no request');
+    callback(null, newestStored(), todayDate);
+    return;
+  }
+  
+  var endpoint = '/usercollection/' + collection + '?start_date=' + open[0] + '&end_date=' + open[open.length - 1];
+  console.log('[oura] Fetching', collection, 'for open days', open.join(', '));
+  
+  makeOuraRequest(endpoint, token, function(error, data) {
+    if (error) {
+      var stored = newestStored();
+      callback(stored ? null : error, stored, todayDate);
+      return;
     }
+    dayStoreUpdate(collection, open, data && data.data);
+    callback(null, newestStored(), todayDate);
   });
 }
 
+// Newest record by its `day` (YYYY-MM-DD compares as a string) that passes isValid;
+// on equal days the later entry wins
+function pickNewestRecord(records, isValid) {
+  var newest = null;
+  if (!records) return null;
+  for (var i = 0; i < records.length; i++) {
+    var rec = records[i];
+    if (!rec || !isValid(rec)) { continue; }
+    if (!newest || (rec.day || '') >= (newest.day || '')) {
+      newest = rec;
+    }
+  }
+  return newest;
+}
+
+function hasScore(rec) {
+  return (rec.score || 0) > 0;
+}
+
+// Cache fallback for readiness: last good score, or unavailable
+function cachedReadinessResult() {
+  var cached = getCachedScore('readiness');
+  if (cached > 0) {
+    console.log('[oura] Using cached readiness score:', cached);
+    sendDebugStatus('Using cached RDY');
+    return {
+      readiness_score: cached,
+      day: getCachedScoreDate(),
+      temperature_deviation: 0,
+      recovery_index: 0,
+      data_available: true
+    };
+  }
+  return { data_available: false };
+}
+
 function fetchReadinessData(token, callback) {
-  // Try today's data first
-  var todayDate = getOuraDataDate();
-  var endpoint = '/usercollection/daily_readiness?start_date=' + todayDate + '&end_date=' + todayDate;
-  
-  console.log('[oura] Fetching readiness data for today:', todayDate);
   sendDebugStatus('Getting readiness...');
   
-  makeOuraRequest(endpoint, token, function(error, data) {
+  fetchRecentDaily('daily_readiness', token, hasScore, function(error, record, todayDate) {
     if (error) {
       console.error('Failed to fetch readiness data:', error);
       sendDebugStatus('RDY API failed');
-      
-      // If API fails but we have a cached value, use it
-      if (g_cached_readiness_score > 0) {
-        console.log('[oura] Using cached readiness score after API error:', g_cached_readiness_score);
-        sendDebugStatus('Using cached RDY');
-        callback({
-          readiness_score: g_cached_readiness_score,
-          temperature_deviation: 0,
-          recovery_index: 0,
-          data_available: true
-        });
-        return;
-      }
-      
-      callback({ data_available: false });
+      callback(cachedReadinessResult());
       return;
     }
-    
-    var result = { data_available: false };
-    
-    // Check if we have data for today
-    if (data && data.data && data.data.length > 0) {
-      var latestData = data.data[data.data.length - 1];
-      var currentScore = latestData.score || 0;
-      
-      if (currentScore > 0) {
-        // Fresh data available for today!
-        g_cached_readiness_score = currentScore;
-        g_cache_date = todayDate;
-        console.log('[oura] Readiness: Fresh data for today:', currentScore);
-        sendDebugStatus('RDY updated (today)');
-        saveCachedScores();
-        
-        result = {
-          readiness_score: currentScore,
-          temperature_deviation: latestData.temperature_deviation || 0,
-          recovery_index: latestData.recovery_index || 0,
-          data_available: true
-        };
-        callback(result);
-        return;
-      }
+    if (!record) {
+      console.log('[oura] No scored readiness for yesterday or today');
+      callback(cachedReadinessResult());
+      return;
     }
     
-    // No data for today, try yesterday as fallback
-    console.log('[oura] No readiness data for today, trying yesterday...');
-    var yesterdayDate = getYesterdayDate();
-    var fallbackEndpoint = '/usercollection/daily_readiness?start_date=' + yesterdayDate + '&end_date=' + yesterdayDate;
-    
-    makeOuraRequest(fallbackEndpoint, token, function(fallbackError, fallbackData) {
-      if (fallbackError) {
-        console.error('Failed to fetch yesterday readiness data:', fallbackError);
-        
-        // Use cached value if available
-        if (g_cached_readiness_score > 0) {
-          console.log('[oura] Using cached readiness score');
-          sendDebugStatus('Using cached RDY');
-          callback({
-            readiness_score: g_cached_readiness_score,
-            temperature_deviation: 0,
-            recovery_index: 0,
-            data_available: true
-          });
-          return;
-        }
-        
-        callback({ data_available: false });
-        return;
-      }
-      
-      if (fallbackData && fallbackData.data && fallbackData.data.length > 0) {
-        var yesterdayData = fallbackData.data[fallbackData.data.length - 1];
-        var yesterdayScore = yesterdayData.score || 0;
-        
-        if (yesterdayScore > 0) {
-          // Only update cache if this is newer than what we have
-          if (g_cache_date !== yesterdayDate) {
-            g_cached_readiness_score = yesterdayScore;
-            g_cache_date = yesterdayDate;
-            console.log('[oura] Readiness: Updated with yesterday data:', yesterdayScore);
-            sendDebugStatus('RDY updated (yesterday)');
-            saveCachedScores();
-          }
-          
-          callback({
-            readiness_score: yesterdayScore,
-            temperature_deviation: yesterdayData.temperature_deviation || 0,
-            recovery_index: yesterdayData.recovery_index || 0,
-            data_available: true
-          });
-          return;
-        }
-      }
-      
-      // Still no data, use cached if available
-      if (g_cached_readiness_score > 0) {
-        console.log('[oura] Using cached readiness score as final fallback');
-        sendDebugStatus('Using cached RDY');
-        callback({
-          readiness_score: g_cached_readiness_score,
-          temperature_deviation: 0,
-          recovery_index: 0,
-          data_available: true
-        });
-      } else {
-        callback({ data_available: false });
-      }
+    var isToday = record.day === todayDate;
+    // Today's score always replaces the cache; yesterday's only if it is not cached yet
+    if (isToday || getCachedScoreDate() !== record.day) {
+      setCachedScore('readiness', record.score, record.day || todayDate);
+    }
+    console.log('[oura] Readiness:', record.score, 'for', record.day);
+    sendDebugStatus('RDY updated (' + (isToday ? 'today' : 'yesterday') + ')');
+    callback({
+      readiness_score: record.score,
+      day: record.day,
+      temperature_deviation: record.temperature_deviation || 0,
+      recovery_index: record.recovery_index || (record.contributors && record.contributors.recovery_index) || 0,
+      data_available: true
     });
   });
 }
 
+// Cache fallback for sleep: last good score, or unavailable
+function cachedSleepResult() {
+  var cached = getCachedScore('sleep');
+  if (cached > 0) {
+    console.log('[oura] Using cached sleep score:', cached);
+    sendDebugStatus('Using cached sleep');
+    return {
+      sleep_score: cached,
+      day: getCachedScoreDate(),
+      data_available: true
+    };
+  }
+  return { data_available: false };
+}
+
 function fetchSleepData(token, callback) {
-  // Try today's data first
-  var todayDate = getOuraDataDate();
-  var endpoint = '/usercollection/daily_sleep?start_date=' + todayDate + '&end_date=' + todayDate;
+  var result = null;
+  var period;   // undefined until the sleep period answers
   
-  console.log('[oura] Fetching sleep data for today:', todayDate);
   sendDebugStatus('Getting sleep...');
   
-  makeOuraRequest(endpoint, token, function(error, data) {
+  // Durations only count when they belong to the night that was scored
+  function done() {
+    if (!result || period === undefined) return;
+    if (result.data_available && period && period.day === result.day) {
+      result.total_sleep_time = Math.round((period.total_sleep_duration || 0) / 60);
+      result.deep_sleep_time = Math.round((period.deep_sleep_duration || 0) / 60);
+    }
+    callback(result);
+  }
+  
+  fetchSleepPeriod(token, function(p) {
+    period = p;
+    done();
+  });
+  
+  fetchRecentDaily('daily_sleep', token, hasScore, function(error, record, todayDate) {
     if (error) {
       console.error('Failed to fetch sleep data:', error);
       sendDebugStatus('Sleep API failed');
-      
-      // If API fails but we have a cached value, use it
-      if (g_cached_sleep_score > 0) {
-        console.log('[oura] Using cached sleep score after API error:', g_cached_sleep_score);
-        sendDebugStatus('Using cached sleep');
-        callback({
-          sleep_score: g_cached_sleep_score,
-          total_sleep_duration: 0,
-          sleep_efficiency: 0,
-          data_available: true
-        });
-        return;
-      }
-      
-      callback({ data_available: false });
+      result = cachedSleepResult();
+      done();
       return;
     }
-    
-    var result = { data_available: false };
-    
-    // Check if we have data for today
-    if (data && data.data && data.data.length > 0) {
-      var latestData = data.data[data.data.length - 1];
-      var currentScore = latestData.score || 0;
-      
-      if (currentScore > 0) {
-        // Fresh data available for today!
-        g_cached_sleep_score = currentScore;
-        g_cache_date = todayDate;
-        console.log('[oura] Sleep: Fresh data for today:', currentScore);
-        sendDebugStatus('Sleep updated (today)');
-        saveCachedScores();
-        
-        result = {
-          sleep_score: currentScore,
-          total_sleep_duration: latestData.total_sleep_duration || 0,
-          sleep_efficiency: latestData.efficiency || 0,
-          data_available: true
-        };
-        callback(result);
-        return;
-      }
+    if (!record) {
+      console.log('[oura] No scored sleep for yesterday or today');
+      result = cachedSleepResult();
+      done();
+      return;
     }
     
-    // No data for today, try yesterday as fallback
-    console.log('[oura] No sleep data for today, trying yesterday...');
-    var yesterdayDate = getYesterdayDate();
-    var fallbackEndpoint = '/usercollection/daily_sleep?start_date=' + yesterdayDate + '&end_date=' + yesterdayDate;
-    
-    makeOuraRequest(fallbackEndpoint, token, function(fallbackError, fallbackData) {
-      if (fallbackError) {
-        console.error('Failed to fetch yesterday sleep data:', fallbackError);
-        
-        // Use cached value if available
-        if (g_cached_sleep_score > 0) {
-          console.log('[oura] Using cached sleep score');
-          sendDebugStatus('Using cached sleep');
-          callback({
-            sleep_score: g_cached_sleep_score,
-            total_sleep_duration: 0,
-            sleep_efficiency: 0,
-            data_available: true
-          });
-          return;
-        }
-        
-        callback({ data_available: false });
-        return;
-      }
-      
-      if (fallbackData && fallbackData.data && fallbackData.data.length > 0) {
-        var yesterdayData = fallbackData.data[fallbackData.data.length - 1];
-        var yesterdayScore = yesterdayData.score || 0;
-        
-        if (yesterdayScore > 0) {
-          // Only update cache if this is newer than what we have
-          if (g_cache_date !== yesterdayDate) {
-            g_cached_sleep_score = yesterdayScore;
-            g_cache_date = yesterdayDate;
-            console.log('[oura] Sleep: Updated with yesterday data:', yesterdayScore);
-            sendDebugStatus('Sleep updated (yesterday)');
-            saveCachedScores();
-          }
-          
-          callback({
-            sleep_score: yesterdayScore,
-            total_sleep_duration: yesterdayData.total_sleep_duration || 0,
-            sleep_efficiency: yesterdayData.efficiency || 0,
-            data_available: true
-          });
-          return;
-        }
-      }
-      
-      // Still no data, use cached if available
-      if (g_cached_sleep_score > 0) {
-        console.log('[oura] Using cached sleep score as final fallback');
-        sendDebugStatus('Using cached sleep');
-        callback({
-          sleep_score: g_cached_sleep_score,
-          total_sleep_duration: 0,
-          sleep_efficiency: 0,
-          data_available: true
-        });
-      } else {
-        callback({ data_available: false });
-      }
-    });
+    var isToday = record.day === todayDate;
+    // Today's score always replaces the cache; yesterday's only if it is not cached yet
+    if (isToday || getCachedScoreDate() !== record.day) {
+      setCachedScore('sleep', record.score, record.day || todayDate);
+    }
+    console.log('[oura] Sleep:', record.score, 'for', record.day);
+    sendDebugStatus('Sleep updated (' + (isToday ? 'today' : 'yesterday') + ')');
+    result = {
+      sleep_score: record.score,
+      day: record.day,
+      data_available: true
+    };
+    done();
   });
 }
 
 function fetchActivityData(token, callback) {
-  // Try a wider date range to find activity data
   var todayDate = getOuraDataDate();
-  var threeDaysAgo = new Date();
-  threeDaysAgo.setDate(threeDaysAgo.getDate() - 3);
-  var startDate = threeDaysAgo.toISOString().split('T')[0];
+  sendDebugStatus('Getting activity...');
   
-  var endpoint = '/usercollection/daily_activity?start_date=' + startDate + '&end_date=' + todayDate;
-  
-  console.log('[oura] Fetching activity data from', startDate, 'to', todayDate);
-  sendDebugStatus('Getting activity (wide range)...');
+  // Today's record counts even with a score of 0 (the day is still running);
+  // yesterday's only with a score
+  function usable(rec) {
+    return rec.day === todayDate ? !rec.empty : hasScore(rec);
+  }
   
-  makeOuraRequest(endpoint, token, function(error, data) {
-    console.log('[oura] ===== ACTIVITY DEBUG START =====');
-    console.log('[oura] Activity: Raw response data:', data);
-    if (data && data.data) {
-      console.log('[oura] Activity: Data array length:', data.data.length);
-      if (data.data.length > 0) {
-        console.log('[oura] Activity: First item keys:', Object.keys(data.data[0]));
-        console.log('[oura] Activity: First item score:', data.data[0].score);
+  fetchRecentDaily('daily_activity', token, usable, function(error, record) {
+    if (error || !record) {
+      if (error) {
+        console.error('Failed to fetch activity data:', error);
+        sendDebugStatus('Activity API failed');
       }
-    }
-    console.log('[oura] ===== ACTIVITY DEBUG END =====');
-    
-    if (error) {
-      console.error('Failed to fetch activity data:', error);
-      sendDebugStatus('Activity API failed');
-      
       // Try cached activity score only if it's for TODAY
-      try {
-        var cachedRaw = localStorage.getItem('oura_cached_scores');
-        var today = getLocalDateString();
-        if (cachedRaw) {
-          var cached = JSON.parse(cachedRaw);
-          if (cached.activity_score > 0 && cached.activity_date === today) {
-            console.log('[oura] Using cached TODAY activity after API error:', cached.activity_score);
-            callback({
-              activity_score: cached.activity_score,
-              active_calories: 0,
-              steps: 0,
-              data_available: true
-            });
-            return;
-          }
-        }
-      } catch (e) { console.warn('Activity cache parse error:', e); }
-      
-      // Try yesterday as fallback
-      var yesterdayDate = getYesterdayDate();
-      var fallbackEndpoint = '/usercollection/daily_activity?start_date=' + yesterdayDate + '&end_date=' + yesterdayDate;
-      console.log('[oura] Activity: Fallback request for yesterday:', fallbackEndpoint);
-      
-      makeOuraRequest(fallbackEndpoint, token, function(fallbackError, fallbackData) {
-        if (fallbackError) {
-          console.error('Failed to fetch yesterday activity data:', fallbackError);
-          callback({ data_available: false });
-          return;
-        }
-        
-        console.log('[oura] Activity: Fallback response records:', fallbackData.data.length);
-        if (fallbackData && fallbackData.data && fallbackData.data.length > 0) {
-          var yesterdayActivity = fallbackData.data[fallbackData.data.length - 1];
-          console.log('[oura] Activity: Fallback picked record day:', yesterdayActivity.day, 'score:', yesterdayActivity.score);
-          // Only return data if we have a valid score
-          if (yesterdayActivity.score > 0) {
-            // Cache with yesterday date to prevent confusion
-            g_cached_activity_score = yesterdayActivity.score;
-            g_cache_date = yesterdayDate;
-            saveCachedScores();
-            sendDebugStatus('Activity yesterday ' + yesterdayDate + ': ' + yesterdayActivity.score);
-            callback({
-              activity_score: yesterdayActivity.score,
-              active_calories: yesterdayActivity.active_calories || 0,
-              steps: yesterdayActivity.steps || 0,
-              data_available: true
-            });
-          } else {
-            console.log('[oura] Activity: No valid yesterday score, marking as unavailable');
-            callback({ data_available: false });
-          }
-        } else {
-          callback({ data_available: false });
-        }
-      });
-      return;
-    }
-    
-    if (data && data.data && data.data.length > 0) {
-      console.log('[oura] Activity: TodayDate', todayDate, 'Found', data.data.length, 'activity records');
-      for (var i = 0; i < data.data.length; i++) {
-        var record = data.data[i];
-        console.log('[oura] Activity record', i + ':', 'day=' + record.day, 'score=' + record.score);
-      }
-
-      // Prefer today's record explicitly by date match
-      var todayRecord = null;
-      for (var ti = 0; ti < data.data.length; ti++) {
-        if (data.data[ti].day === todayDate) {
-          todayRecord = data.data[ti];
-          break;
-        }
-      }
-
-      if (todayRecord) {
-        // If there's a record for today, use it directly. If score is 0, treat as 0 (no fallback to yesterday).
-        var todayScore = todayRecord.score || 0;
-        console.log('[oura] Activity: Using TODAY record', todayDate, 'score:', todayScore);
-        sendDebugStatus('Activity today ' + todayDate + ': ' + todayScore);
-        g_cached_activity_score = todayScore;
-        g_cache_date = todayDate;
-        saveCachedScores();
+      var cached = getCachedScore('activity');
+      if (cached > 0) {
+        console.log('[oura] Using cached TODAY activity:', cached);
         callback({
-          activity_score: todayScore,
-          active_calories: todayRecord.active_calories || 0,
-          steps: todayRecord.steps || 0,
+          activity_score: cached,
+          active_calories: 0,
+          steps: 0,
           data_available: true
         });
-      } else {
-        // If today's record missing entirely, check yesterday within same dataset
-        var yesterdayDate = getYesterdayDate();
-        var yRecord = null;
-        for (var yi = 0; yi < data.data.length; yi++) {
-          if (data.data[yi].day === yesterdayDate) {
-            yRecord = data.data[yi];
-            break;
-          }
-        }
-        if (yRecord && (yRecord.score || 0) > 0) {
-          var yScore = yRecord.score || 0;
-          console.log('[oura] Activity: Using YESTERDAY record', yesterdayDate, 'score:', yScore);
-          sendDebugStatus('Activity yesterday ' + yesterdayDate + ': ' + yScore);
-          // Optionally cache yesterday with its date
-          g_cached_activity_score = yScore;
-          g_cache_date = yesterdayDate;
-          saveCachedScores();
-          callback({
-            activity_score: yScore,
-            active_calories: yRecord.active_calories || 0,
-            steps: yRecord.steps || 0,
-            data_available: true
-          });
-        } else {
-          console.log('[oura] Activity: No valid today/yesterday score in range, marking as unavailable');
-          callback({ data_available: false });
-        }
+        return;
       }
-    } else {
-      // No data for today, try yesterday
-      console.log('[oura] No activity data for today, trying yesterday...');
-      var yesterdayDate = getYesterdayDate();
-      var fallbackEndpoint = '/usercollection/daily_activity?start_date=' + yesterdayDate + '&end_date=' + yesterdayDate;
-      
-      makeOuraRequest(fallbackEndpoint, token, function(fallbackError, fallbackData) {
-        if (fallbackError) {
-          console.error('Failed to fetch yesterday activity data:', fallbackError);
-          callback({ data_available: false });
-          return;
-        }
-        
-        if (fallbackData && fallbackData.data && fallbackData.data.length > 0) {
-          var yesterdayActivity = fallbackData.data[fallbackData.data.length - 1];
-          console.log('[oura] Activity: Updated with yesterday data, score:', yesterdayActivity.score);
-          sendDebugStatus('Activity updated (yesterday)');
-          
-          // Only return data if we have a valid score
-          if (yesterdayActivity.score > 0) {
-            callback({
-              activity_score: yesterdayActivity.score,
-              active_calories: yesterdayActivity.active_calories || 0,
-              steps: yesterdayActivity.steps || 0,
-              data_available: true
-            });
-          } else {
-            console.log('[oura] Activity: No valid yesterday score, marking as unavailable');
-            callback({ data_available: false });
-          }
-        } else {
-          // No data for yesterday either, try cached activity for TODAY only
-          try {
-            var cachedRaw2 = localStorage.getItem('oura_cached_scores');
-            var today2 = getLocalDateString();
-            if (cachedRaw2) {
-              var cached2 = JSON.parse(cachedRaw2);
-              if (cached2.activity_score > 0 && cached2.activity_date === today2) {
-                console.log('[oura] Using cached TODAY activity after no data found:', cached2.activity_score);
-                callback({
-                  activity_score: cached2.activity_score,
-                  active_calories: 0,
-                  steps: 0,
-                  data_available: true
-                });
-                return;
-              }
-            }
-          } catch (e2) { console.warn('Activity cache parse error:', e2); }
-          callback({ data_available: false });
-        }
-      });
+      console.log('[oura] Activity: No valid today/yesterday record, marking as unavailable');
+      callback({ data_available: false });
+      return;
     }
+    
+    var score = record.score || 0;
+    var label = record.day === todayDate ? 'today' : 'yesterday';
+    console.log('[oura] Activity: Using', label, 'record', record.day, 'score:', score);
+    sendDebugStatus('Activity ' + label + ' ' + record.day + ': ' + score);
+    if (score > 0) {
+      setCachedScore('activity', score, record.day);
+    }
+    callback({
+      activity_score: score,
+      day: record.day,
+      active_calories: record.active_calories || 0,
+      steps: record.steps || 0,
+      data_available: true
+    });
   });
 }
 
+function hasStress(rec) {
+  return rec.stress_high !== undefined && rec.stress_high !== null;
+}
+
 function fetchStressData(token, callback) {
-  // Try today's data first
-  var todayDate = getOuraDataDate();
-  var endpoint = '/usercollection/daily_stress?start_date=' + todayDate + '&end_date=' + todayDate;
-  
-  console.log('[oura] Fetching stress data for today:', todayDate);
   sendDebugStatus('Getting stress...');
   
-  makeOuraRequest(endpoint, token, function(error, data) {
+  fetchRecentDaily('daily_stress', token, hasStress, function(error, record, todayDate) {
     if (error) {
       console.error('Failed to fetch stress data:', error);
       sendDebugStatus('Stress API failed');
-      
-      // Try yesterday as fallback
-      var yesterdayDate = getYesterdayDate();
-      var fallbackEndpoint = '/usercollection/daily_stress?start_date=' + yesterdayDate + '&end_date=' + yesterdayDate;
-      
-      makeOuraRequest(fallbackEndpoint, token, function(fallbackError, fallbackData) {
-        if (fallbackError) {
-          console.error('Failed to fetch yesterday stress data:', fallbackError);
-          callback({ data_available: false });
-          return;
-        }
-        
-        if (fallbackData && fallbackData.data && fallbackData.data.length > 0) {
-          var yesterdayStress = fallbackData.data[fallbackData.data.length - 1];
-          // Only return data if we have valid stress data
-          if (yesterdayStress.stress_high !== undefined && yesterdayStress.stress_high !== null) {
-            callback({
-              stress_duration: yesterdayStress.stress_high,
-              stress_high_duration: yesterdayStress.stress_high,
-              data_available: true
-            });
-          } else {
-            console.log('[oura] Stress: No valid yesterday data, marking as unavailable');
-            callback({ data_available: false });
-          }
-        } else {
-          callback({ data_available: false });
-        }
-      });
+      callback({ data_available: false });
       return;
     }
-    
-    if (data && data.data && data.data.length > 0) {
-      var latestStress = data.data[data.data.length - 1];
-      console.log('[oura] ===== STRESS DEBUG START =====');
-      console.log('[oura] Stress: Raw stress data received:', JSON.stringify(latestStress));
-      console.log('[oura] Stress: Available fields:', Object.keys(latestStress));
-      console.log('[oura] Stress: stress_high value:', latestStress.stress_high);
-      console.log('[oura] Stress: stress_high type:', typeof latestStress.stress_high);
-      
-      // Only return data if we have valid stress data
-      if (latestStress.stress_high !== undefined && latestStress.stress_high !== null) {
-        var stressSeconds = latestStress.stress_high;
-        var stressMinutes = stressSeconds / 60; // Calculate minutes for display
-        
-        console.log('[oura] Stress: Final stress seconds (raw from API):', stressSeconds);
-        console.log('[oura] Stress: Final stress minutes (calculated):', stressMinutes);
-        console.log('[oura] ===== STRESS DEBUG END =====');
-        sendDebugStatus('Stress updated (today)');
-        
-        callback({
-          stress_duration: stressSeconds, // Send as seconds to match C code expectation
-          stress_high_duration: stressSeconds,
-          data_available: true
-        });
-      } else {
-        console.log('[oura] Stress: No valid stress data found, marking as unavailable');
-        callback({ data_available: false });
-      }
-    } else {
-      // No data for today, try yesterday
-      console.log('[oura] No stress data for today, trying yesterday...');
-      var yesterdayDate = getYesterdayDate();
-      var fallbackEndpoint = '/usercollection/daily_stress?start_date=' + yesterdayDate + '&end_date=' + yesterdayDate;
-      
-      makeOuraRequest(fallbackEndpoint, token, function(fallbackError, fallbackData) {
-        if (fallbackError) {
-          console.error('Failed to fetch yesterday stress data:', fallbackError);
-          callback({ data_available: false });
-          return;
-        }
-        
-        if (fallbackData && fallbackData.data && fallbackData.data.length > 0) {
-          var yesterdayStress = fallbackData.data[fallbackData.data.length - 1];
-          console.log('[oura] Stress: Raw yesterday stress data:', JSON.stringify(yesterdayStress));
-          console.log('[oura] Stress: Available yesterday fields:', Object.keys(yesterdayStress));
-          
-          // Only return data if we have valid stress data
-          if (yesterdayStress.stress_high !== undefined && yesterdayStress.stress_high !== null) {
-            var stressSeconds = yesterdayStress.stress_high;
-            var stressMinutes = stressSeconds / 60; // Calculate minutes for display
-            
-            console.log('[oura] Stress: Yesterday stress_high field:', yesterdayStress.stress_high, 'seconds');
-            console.log('[oura] Stress: Yesterday stress minutes calculated:', stressMinutes, 'minutes');
-            sendDebugStatus('Stress updated (yesterday)');
-            
-            callback({
-              stress_duration: stressSeconds, // Send as seconds to match C code expectation
-              stress_high_duration: stressSeconds,
-              data_available: true
-            });
-          } else {
-            console.log('[oura] Stress: No valid yesterday stress data, marking as unavailable');
-            callback({ data_available: false });
-          }
-        } else {
-          callback({ data_available: false });
-        }
-      });
+    if (!record) {
+      console.log('[oura] Stress: No valid data for yesterday or today, marking as unavailable');
+      callback({ data_available: false });
+      return;
     }
+    
+    var stressSeconds = record.stress_high;
+    console.log('[oura] Stress:', stressSeconds, 'seconds (' + (stressSeconds / 60) + ' minutes) for', record.day);
+    sendDebugStatus('Stress updated (' + (record.day === todayDate ? 'today' : 'yesterday') + ')');
+    callback({
+      stress_duration: stressSeconds, // Send as seconds to match C code expectation
+      stress_high_duration: stressSeconds,
+      day: record.day,
+      data_available: true
+    });
   });
 }
 
@@ -1071,8 +956,13 @@ function fetchStressData(token, callback) {
 // DATA AGGREGATION AND WATCH COMMUNICATION
 // =============================================================================
 
-function fetchAllOuraData() {
-  console.log('🚀 Starting to fetch all Oura data...');
+// staleMask: METRIC_BITS of the endpoints to fetch (the watch's stale_mask);
+// omitted means all of them
+function fetchAllOuraData(staleMask) {
+  if (staleMask === undefined || staleMask === null) {
+    staleMask = METRIC_BITS_ALL;
+  }
+  console.log('🚀 Starting to fetch Oura data, mask:', staleMask);
   
   var token = CONFIG_SETTINGS.access_token;
   if (!token || !CONFIG_SETTINGS.connected) {
@@ -1100,87 +990,108 @@ function fetchAllOuraData() {
   
   console.log('✅ Token valid, fetching real data');
   sendDebugStatus('Fetching from Oura API...');
-  // Use the aggregator that waits for all 3 API calls, then sends to the watch
-  console.log('📡 Starting aggregated API calls (3 total)');
-  fetchAllOuraDataLegacy(token);
+  // Use the aggregator that waits for the requested API calls, then sends to the watch
+  fetchAllOuraDataLegacy(token, staleMask);
 }
 
-function fetchAllOuraDataLegacy(token) {
-  var results = {
-    heart_rate: null,
-    readiness: null,
-    sleep: null,
-    activity: null,
-    stress: null
-  };
+function fetchAllOuraDataLegacy(token, staleMask) {
+  // Endpoints not in the mask are left out of the packets; the watch keeps its values
+  var fetchers = [
+    { key: 'heart_rate', fetch: fetchHeartRateData, tag: 'HR' },
+    { key: 'readiness', fetch: fetchReadinessData, tag: 'RDY' },
+    { key: 'sleep', fetch: fetchSleepData, tag: 'Sleep' },
+    { key: 'activity', fetch: fetchActivityData, tag: 'Activity' },
+    { key: 'stress', fetch: fetchStressData, tag: 'Stress' }
+  ].filter(function(f) { return (staleMask & METRIC_BITS[f.key]) !== 0; });
   
   var completed = 0;
-  var total = 5;
-  
-  function checkComplete() {
-    completed++;
-    console.log('API call completed:', completed, 'of', total);
-    sendDebugStatus('API ' + completed + '/' + total + ' done');
-    
-    if (completed > total) {
-      console.error('ERROR: More completions than expected!', completed, '>', total);
-      sendDebugStatus('ERROR: Too many calls!');
-      return; // Prevent multiple data sends
-    }
-    
-    if (completed === total) {
-      var ouraData = {
-        heart_rate: results.heart_rate || { data_available: false },
-        readiness: results.readiness || { data_available: false },
-        sleep: results.sleep || { data_available: false },
-        activity: results.activity || { data_available: false },
-        stress: results.stress || { data_available: false },
-        last_updated: Date.now()
-      };
-      
-      console.log('All Oura data fetched:', ouraData);
-      sendDebugStatus('Sending real data!');
-      localStorage.setItem(STORAGE_KEYS.LAST_UPDATE, Date.now().toString());
-      setTimeout(function() {
-        sendDataToWatch(ouraData);
-      }, ACTIVITY_SEND_DELAY_MS);
-    }
+  var total = fetchers.length;
+  var stream = createMetricStream();
+  console.log('📡 Starting streamed API calls (' + total + ' total)');
+  
+  function finish(lastKey, lastData) {
+    console.log('All Oura data fetched');
+    sendDebugStatus('Sending real data!');
+    stream.complete(lastKey, lastData);
+    flushState();
   }
   
-  fetchHeartRateData(token, function(data) {
-    console.log('Heart rate callback received:', data);
-    results.heart_rate = data;
-    sendDebugStatus('HR callback done');
-    checkComplete();
-  });
-  
-  fetchReadinessData(token, function(data) {
-    console.log('Readiness callback received:', data);
-    results.readiness = data;
-    sendDebugStatus('RDY callback done');
-    checkComplete();
-  });
-  
-  fetchSleepData(token, function(data) {
-    console.log('Sleep callback received:', data);
-    results.sleep = data;
-    sendDebugStatus('Sleep callback done');
-    checkComplete();
-  });
+  if (total === 0) {
+    finish(); // nothing stale: still answer so the watch request completes
+    return;
+  }
   
-  fetchActivityData(token, function(data) {
-    console.log('Activity callback received:', data);
-    results.activity = data;
-    sendDebugStatus('Activity callback done');
-    checkComplete();
+  fetchers.forEach(function(f) {
+    f.fetch(token, function(data) {
+      completed++;
+      console.log(f.tag + ' callback received (' + completed + '/' + total + '):', data);
+      if (completed > total) {
+        console.error('ERROR: More completions than expected!', completed, '>', total);
+        sendDebugStatus('ERROR: Too many calls!');
+        return; // Prevent multiple data sends
+      }
+      sendDebugStatus('API ' + completed + '/' + total + ' done (' + f.tag + ')');
+      // Each metric goes out as soon as it resolves; the last one completes the payload
+      if (completed === total) {
+        finish(f.key, data);
+      } else {
+        stream.push(f.key, data);
+      }
+    });
   });
+}
+
+// -----------------------------------------------------------------------------
+// Metric stream: per-metric partial packets, merged while still queued
+// -----------------------------------------------------------------------------
+// Every update is a metrics packet whose fetched_mask names the metrics it
+// carries, so the watch folds it into what it already shows. An update still
+// waiting in the AppMessage queue absorbs the next one instead of queueing a
+// second message. complete() adds the last metric (if any), the watch settings
+// and payload_complete to the pending update, ending the stream.
+function createMetricStream() {
+  var pending = null;   // { item, data, mask } while the queued message is unsent
+  var finished = false;
+  
+  function update(key, data, complete) {
+    if (!pending || !isMessagePending(pending.item)) {
+      pending = { item: null, data: {}, mask: 0 };
+    }
+    if (key) {
+      pending.data[key] = data || { data_available: false };
+      pending.mask |= METRIC_BITS[key];
+    }
+    pending.data.fetched_mask = pending.mask;
+    pending.data.last_updated = Date.now();
+    var payload = { metrics_packet: encodeMetricsPacket(pending.data) };
+    if (complete) {
+      appendWatchSettings(payload);
+      payload.payload_complete = 1;
+    }
+    if (pending.item) {
+      pending.item.payload = payload;
+      console.log('[stream] merged ' + (key || 'completion') + ' into queued update, mask ' + pending.mask);
+    } else {
+      pending.item = enqueueMessage(payload, null, function(err) {
+        console.error('[stream] Failed to send metric update:', err);
+      });
+      console.log('[stream] queued ' + (key || 'completion') + ', mask ' + pending.mask);
+    }
+  }
   
-  fetchStressData(token, function(data) {
-    console.log('Stress callback received:', data);
-    results.stress = data;
-    sendDebugStatus('Stress callback done');
-    checkComplete();
-  });
+  return {
+    push: function(key, data) {
+      if (!finished) {
+        update(key, data, false);
+      }
+    },
+    complete: function(key, data) {
+      if (!finished) {
+        finished = true;
+        update(key || null, data, true);
+      }
+    }
+  };
 }
 
 function loadSampleData() {
@@ -1189,33 +1100,6 @@ function loadSampleData() {
   sendSampleDataToWatch();
 }
 
-// Get currently cached Oura data for immediate layout updates
-function getCachedOuraData() {
-  // Return cached data if available
-  if (g_cached_readiness_score > 0 || g_cached_sleep_score > 0) {
-    return {
-      readiness: {
-        readiness_score: g_cached_readiness_score,
-        temperature_deviation: 0,
-        recovery_index: g_cached_readiness_score,
-        data_available: g_cached_readiness_score > 0
-      },
-      sleep: {
-        sleep_score: g_cached_sleep_score,
-        total_sleep_time: 450, // Default reasonable value
-        deep_sleep_time: 90,   // Default reasonable value
-        data_available: g_cached_sleep_score > 0
-      },
-      heart_rate: {
-        resting_heart_rate: 65, // Default reasonable value
-        hrv_score: 45,          // Default reasonable value
-        data_available: true
-      }
-    };
-  }
-  return null; // No cached data available
-}
-
 function sendSampleDataToWatch() {
   var sampleData = {
     heart_rate: {
@@ -1253,6 +1137,7 @@ function sendSampleDataToWatch() {
 }
 
 var DEBUG_THROTTLE_MS = 1000; // min gap between debug sends
+var DEBUG_MAX_LEN = 96; // keep debug strings well inside the watch's 256-byte inbox
 var g_last_debug_sent_at = 0;
 var g_pending_debug = null;
 function sendDebugStatus(message) {
@@ -1261,6 +1146,7 @@ function sendDebugStatus(message) {
     return;
   }
   function doSend(msg) {
+    msg = String(msg).substring(0, DEBUG_MAX_LEN);
     enqueueMessage({ 'debug_status': msg }, function(){
       console.log('Debug status sent:', msg);
     }, function(err){
@@ -1291,15 +1177,89 @@ function sendDebugStatus(message) {
   }, 5 * 60 * 1000);
 }
 
-function sendDataToWatch(data) {
-  // Convert nested data structure to flat message keys that C code expects
-  var flatData = {};
-  
+// -----------------------------------------------------------------------------
+// Metrics packet: one byte-array tuple instead of a key per field.
+// Little-endian, must match decode_metrics_packet() in the watch C code. Layout v1:
+//   0 u8 version, 1 u8 availability bits, 2 u32 data date (YYYYMMDD),
+//   6 i16 resting_heart_rate, 8 i16 hrv_score, 10 i16 readiness_score,
+//   12 i16 temperature_deviation, 14 i16 recovery_index, 16 i16 sleep_score,
+//   18 i16 total_sleep_time, 20 i16 deep_sleep_time, 22 i16 activity_score,
+//   24 i16 active_calories, 26 i32 steps, 30 i32 stress_duration,
+//   34 i32 stress_high_duration, 38 u32 last_updated (unix seconds)
+// v2 appends 42 u8 fetched bits (METRIC_BITS): the watch only takes those groups,
+// and 43 u8 fetched bits whose record is from an earlier day than the data date
+// (a yesterday fallback): shown, but kept out of the watch's daily history.
+// -----------------------------------------------------------------------------
+var METRICS_PACKET_VERSION = 2;
+var METRIC_BITS = {
+  heart_rate: 1,
+  readiness: 2,
+  sleep: 4,
+  activity: 8,
+  stress: 16
+};
+var METRIC_BITS_ALL = 31;
+
+function pushLE(bytes, value, size) {
+  var v = Math.round(Number(value) || 0);
+  for (var i = 0; i < size; i++) {
+    bytes.push(v & 0xFF);
+    v = Math.floor(v / 256); // works past 31 bits, unlike >>
+  }
+}
+
+function encodeMetricsPacket(data) {
+  var hr = data.heart_rate || {};
+  var rdy = data.readiness || {};
+  var slp = data.sleep || {};
+  var act = data.activity || {};
+  var str = data.stress || {};
+  
+  var available = 0;
+  if (hr.data_available) available |= METRIC_BITS.heart_rate;
+  if (rdy.data_available) available |= METRIC_BITS.readiness;
+  if (slp.data_available) available |= METRIC_BITS.sleep;
+  if (act.data_available) available |= METRIC_BITS.activity;
+  if (str.data_available) available |= METRIC_BITS.stress;
+  
+  // Results carry the `day` of their record; today's values leave it unset
+  var date = getLocalDateString();
+  var earlier = 0;
+  if (hr.day && hr.day !== date) earlier |= METRIC_BITS.heart_rate;
+  if (rdy.day && rdy.day !== date) earlier |= METRIC_BITS.readiness;
+  if (slp.day && slp.day !== date) earlier |= METRIC_BITS.sleep;
+  if (act.day && act.day !== date) earlier |= METRIC_BITS.activity;
+  if (str.day && str.day !== date) earlier |= METRIC_BITS.stress;
+  
+  var bytes = [METRICS_PACKET_VERSION, available];
+  pushLE(bytes, parseInt(date.replace(/-/g, ''), 10), 4);
+  pushLE(bytes, hr.resting_heart_rate, 2);
+  pushLE(bytes, hr.hrv_score, 2);
+  pushLE(bytes, rdy.readiness_score, 2);
+  pushLE(bytes, (Number(rdy.temperature_deviation) || 0) * 100, 2); // degrees C -> hundredths
+  pushLE(bytes, rdy.recovery_index, 2);
+  pushLE(bytes, slp.sleep_score, 2);
+  pushLE(bytes, slp.total_sleep_time, 2); // minutes
+  pushLE(bytes, slp.deep_sleep_time, 2);
+  pushLE(bytes, act.activity_score, 2);
+  pushLE(bytes, act.active_calories, 2);
+  pushLE(bytes, act.steps, 4);
+  pushLE(bytes, str.stress_duration, 4);
+  pushLE(bytes, str.stress_high_duration, 4);
+  pushLE(bytes, Math.floor((data.last_updated || Date.now()) / 1000), 4);
+  var fetched = data.fetched_mask !== undefined ? data.fetched_mask : METRIC_BITS_ALL;
+  bytes.push(fetched);
+  bytes.push(earlier & fetched);
+  return bytes;
+}
+
+// Layout, date format, theme and loading preferences that accompany every
+// complete data payload
+function appendWatchSettings(flatData) {
   // Add measurement layout configuration
-  var savedLayout = localStorage.getItem('oura_measurement_layout');
-  if (savedLayout) {
+  var layoutConfig = getSetting('measurement_layout');
+  if (layoutConfig) {
     try {
-      var layoutConfig = JSON.parse(savedLayout);
       // Config page saves numeric strings ('0', '1', '2'), convert to integers
       // 0=readiness, 1=sleep, 2=heart_rate
       
@@ -1310,9 +1270,6 @@ function sendDataToWatch(data) {
       
       // Add flexible layout fields for 2-row support
       flatData.layout_rows = (layoutConfig.rows !== undefined && layoutConfig.rows !== null) ? parseInt(layoutConfig.rows) : 1;
-      flatData.row1_left = flatData.layout_left;
-      flatData.row1_middle = flatData.layout_middle;
-      flatData.row1_right = flatData.layout_right;
       flatData.row2_left = (layoutConfig.row2_left !== undefined && layoutConfig.row2_left !== null) ? parseInt(layoutConfig.row2_left) : 3;
       flatData.row2_right = (layoutConfig.row2_right !== undefined && layoutConfig.row2_right !== null) ? parseInt(layoutConfig.row2_right) : 4;
       
@@ -1335,105 +1292,38 @@ function sendDataToWatch(data) {
     console.log('[oura] No saved layout, using default positions');
   }
   
-  // Add date format configuration - always get the most current value from localStorage
-  var dateFormat = localStorage.getItem('oura_date_format') || '0'; // Use same key as config page
-  flatData.date_format = parseInt(dateFormat); // 0 = MM-DD-YYYY, 1 = DD-MM-YYYY
+  // Add date format configuration
+  flatData.date_format = getSetting('date_format') || 0; // 0 = MM-DD-YYYY, 1 = DD-MM-YYYY
   var formatName = (flatData.date_format === 1) ? 'DD-MM-YYYY' : 'MM-DD-YYYY';
   console.log('[oura] Sending date format:', formatName, '-> value:', flatData.date_format);
   
   // Add theme mode configuration - re-enabled
-  var themeMode = localStorage.getItem('oura_theme_mode'); // '0'=Dark, '1'=Light, '2'=Custom
-  if (themeMode === null || themeMode === undefined || themeMode === '') {
-    themeMode = '0';
-  }
-  flatData.theme_mode = parseInt(themeMode);
+  flatData.theme_mode = getSetting('theme_mode') || 0; // 0=Dark, 1=Light, 2=Custom
   var themeName = (flatData.theme_mode === 1) ? '☀️ Light Mode' : (flatData.theme_mode === 2 ? '🎨 Custom' : '🌙 Dark Mode');
   console.log('[oura] Sending theme mode:', themeName, '-> value:', flatData.theme_mode);
 
   // If using Custom Color, include the selected custom_color_index
   if (flatData.theme_mode === 2) {
-    try {
-      var savedColorJson = localStorage.getItem('oura_custom_color');
-      if (savedColorJson) {
-        var savedColor = JSON.parse(savedColorJson);
-        if (savedColor && typeof savedColor.index === 'number') {
-          flatData.custom_color_index = savedColor.index;
-          console.log('[oura] Sending custom_color_index:', flatData.custom_color_index);
-        }
-      }
-    } catch (e) {
-      console.log('Error reading custom color selection:', e);
+    var savedColor = getSetting('custom_color');
+    if (savedColor && typeof savedColor.index === 'number') {
+      flatData.custom_color_index = savedColor.index;
+      console.log('[oura] Sending custom_color_index:', flatData.custom_color_index);
     }
   }
 
   // Include show_loading preference so watchface can control overlay per refresh
-  try {
-    var showLoadingPref = localStorage.getItem('oura_show_loading');
-    // Config page stores '1'/'0', default to '0' (false) if not set
-    var showLoading = (showLoadingPref === '1');
-    flatData.show_loading = showLoading ? 1 : 0;
-    console.log('[oura] Sending show_loading:', flatData.show_loading);
-  } catch (e) {
-    flatData.show_loading = 0; // Default to false (no loading screen)
-  }
-  
-  // Heart rate data
-  if (data.heart_rate) {
-    flatData.heart_rate = 1; // Indicate heart rate data present
-    flatData.resting_heart_rate = data.heart_rate.resting_heart_rate || 0;
-    flatData.hrv_score = data.heart_rate.hrv_score || 0;
-    flatData.data_available = data.heart_rate.data_available ? 1 : 0;
-  }
-  
-  // Readiness data
-  if (data.readiness) {
-    flatData.readiness = 1; // Indicate readiness data present
-    flatData.readiness_score = data.readiness.readiness_score || 0;
-    flatData.temperature_deviation = data.readiness.temperature_deviation || 0;
-    flatData.recovery_index = data.readiness.recovery_index || 0;
-    // Note: reusing data_available key - this might cause issues, need separate keys
-  }
-  
-  // Sleep data
-  if (data.sleep) {
-    flatData.sleep = 1; // Indicate sleep data present
-    flatData.sleep_score = data.sleep.sleep_score || 0;
-    flatData.total_sleep_time = data.sleep.total_sleep_time || 0;
-    flatData.deep_sleep_time = data.sleep.deep_sleep_time || 0;
-    // Note: reusing data_available key - this might cause issues, need separate keys
-  }
-  
-  // Activity data
-  if (data.activity) {
-    if (data.activity.data_available) {
-      flatData.activity_score = data.activity.activity_score || 0;
-      flatData.active_calories = data.activity.active_calories || 0;
-      flatData.steps = data.activity.steps || 0;
-      console.log('[oura] Activity data included:', data.activity);
-    } else {
-      // Mark as unavailable by sending zeros so C shows "--"
-      flatData.activity_score = 0;
-      flatData.active_calories = 0;
-      flatData.steps = 0;
-      console.log('[oura] Activity unavailable - sending zeros');
-    }
-  } else {
-    // No activity block present; ensure zeros
-    flatData.activity_score = 0;
-    flatData.active_calories = 0;
-    flatData.steps = 0;
-    console.log('[oura] No activity data to send');
-  }
+  flatData.show_loading = getSetting('show_loading') ? 1 : 0;
+  console.log('[oura] Sending show_loading:', flatData.show_loading);
+  return flatData;
+}
+
+function sendDataToWatch(data) {
+  // Convert nested data structure to flat message keys that C code expects
+  var flatData = appendWatchSettings({});
   
-  // Stress data - only include when available; allow 0 seconds as valid measurement
-  if (data.stress && data.stress.data_available) {
-    flatData.stress_duration = data.stress.stress_duration || 0; // seconds
-    flatData.stress_high_duration = data.stress.stress_high_duration || 0;
-    console.log('[oura] Stress data included:', data.stress);
-    console.log('[oura] Stress duration being sent:', flatData.stress_duration, 'seconds');
-  } else {
-    console.log('[oura] Stress unavailable - not sending stress fields');
-  }
+  // All metrics travel as one versioned binary packet
+  flatData.metrics_packet = encodeMetricsPacket(data);
+  console.log('[oura] Metrics packet (' + flatData.metrics_packet.length + ' bytes):', JSON.stringify(data));
   
   // Signal that this is a complete aggregated payload
   flatData.payload_complete = 1;
@@ -1505,9 +1395,7 @@ function loadConfigSettings() {
       CONFIG_SETTINGS.token_expires = parseInt(manualExpires) || 0;
       CONFIG_SETTINGS.connected = manualConnected === 'true';
       // Default to showing debug unless explicitly disabled by user setting
-      var storedShowDebug = localStorage.getItem('oura_show_debug');
-      // If key missing, default true. If key present, honor 'true'/'false'
-      CONFIG_SETTINGS.show_debug = (storedShowDebug === null || storedShowDebug === undefined) ? true : (storedShowDebug === 'true');
+      CONFIG_SETTINGS.show_debug = getSetting('show_debug');
       CONFIG_SETTINGS.refresh_frequency = 30;
       
       console.log('✅ Manual setup detected - using manual token');
@@ -1538,19 +1426,12 @@ function loadConfigSettings() {
 Pebble.addEventListener('ready', function() {
   console.log('Oura Stats Watchface JS ready - Secure Client-Side-Only Flow');
   
+  // Read persisted state once; everything below works from memory
+  state();
+  
   // Load configuration settings
   loadConfigSettings();
-  // Load show_loading preference (defaults to false)
-  try {
-    var storedShowLoading = localStorage.getItem('oura_show_loading');
-    if (typeof CONFIG_SETTINGS !== 'undefined') {
-      // Config page stores '1'/'0', default to false if not set
-      CONFIG_SETTINGS.show_loading = (storedShowLoading === '1');
-    }
-  } catch (e) {
-    console.log('Error loading show_loading, defaulting false', e);
-    if (typeof CONFIG_SETTINGS !== 'undefined') CONFIG_SETTINGS.show_loading = false;
-  }
+  CONFIG_SETTINGS.show_loading = getSetting('show_loading');
   
   if (CONFIG_SETTINGS.show_debug) {
     sendDebugStatus('JS Ready');
@@ -1558,10 +1439,7 @@ Pebble.addEventListener('ready', function() {
   
   // Immediately send show_loading preference to the watchface
   try {
-    var slPref = localStorage.getItem('oura_show_loading');
-    // Config page stores '1'/'0', default to false if not set
-    var slVal = (slPref === '1');
-    CONFIG_SETTINGS.show_loading = slVal;
+    var slVal = CONFIG_SETTINGS.show_loading;
     Pebble.sendAppMessage({ 'show_loading': slVal ? 1 : 0 }, function() {
       console.log('✅ Initial show_loading sent:', slVal ? 1 : 0);
     }, function(err) {
@@ -1573,10 +1451,8 @@ Pebble.addEventListener('ready', function() {
 
   // Immediately send time display preferences (show_seconds, compact_time)
   try {
-    var ssPref = localStorage.getItem('oura_show_seconds');
-    var ctPref = localStorage.getItem('oura_compact_time');
-    var ssVal = (ssPref === '1');
-    var ctVal = (ctPref === '1');
+    var ssVal = getSetting('show_seconds');
+    var ctVal = getSetting('compact_time');
     Pebble.sendAppMessage({ 'show_seconds': ssVal ? 1 : 0 }, function() {
       console.log('✅ Initial show_seconds sent:', ssVal ? 1 : 0);
     }, function(err) {
@@ -1593,9 +1469,7 @@ Pebble.addEventListener('ready', function() {
 
   // Immediately send emoji preference (use_emoji)
   try {
-    var uePref = localStorage.getItem('oura_use_emoji');
-    // Stored as '1'/'0' in config page; default to false if not set
-    var ueVal = (uePref === '1');
+    var ueVal = getSetting('use_emoji');
     Pebble.sendAppMessage({ 'use_emoji': ueVal ? 1 : 0 }, function() {
       console.log('✅ Initial use_emoji sent:', ueVal ? 1 : 0);
     }, function(err) {
@@ -1607,8 +1481,7 @@ Pebble.addEventListener('ready', function() {
 
   // Immediately send show_debug and refresh_frequency to the watchface
   try {
-    var storedShowDebug = localStorage.getItem('oura_show_debug');
-    var showDebugVal = (storedShowDebug === null || storedShowDebug === undefined) ? true : (storedShowDebug === 'true');
+    var showDebugVal = getSetting('show_debug');
     CONFIG_SETTINGS.show_debug = showDebugVal;
     Pebble.sendAppMessage({ 'show_debug': showDebugVal ? 1 : 0 }, function() {
       console.log('✅ Initial show_debug sent:', showDebugVal ? 1 : 0);
@@ -1620,8 +1493,7 @@ Pebble.addEventListener('ready', function() {
   }
 
   try {
-    var storedFreq = localStorage.getItem('oura_refresh_frequency');
-    var freqVal = storedFreq ? parseInt(storedFreq) : (CONFIG_SETTINGS.refresh_frequency || 30);
+    var freqVal = getSetting('refresh_frequency') || CONFIG_SETTINGS.refresh_frequency || 30;
     if (freqVal !== 15 && freqVal !== 30 && freqVal !== 60) freqVal = 30;
     CONFIG_SETTINGS.refresh_frequency = freqVal;
     Pebble.sendAppMessage({ 'refresh_frequency': freqVal }, function() {
@@ -1629,8 +1501,6 @@ Pebble.addEventListener('ready', function() {
     }, function(err) {
       console.error('❌ Error sending initial refresh_frequency:', err);
     });
-    // Ensure periodic fetch interval matches
-    updateRefreshInterval();
   } catch (e) {
     console.log('Error determining refresh_frequency on ready:', e);
   }
@@ -1638,21 +1508,15 @@ Pebble.addEventListener('ready', function() {
   // Rehydrate persisted theme/date/colors/layout so user prefs persist across restarts
   try {
     // Theme mode
-    var tm = localStorage.getItem('oura_theme_mode');
-    if (tm !== null && tm !== undefined) {
-      var tmVal = parseInt(tm);
-      if (!isNaN(tmVal)) {
-        Pebble.sendAppMessage({ 'theme_mode': tmVal }, function(){ console.log('✅ Restored theme_mode:', tmVal); }, function(err){ console.error('❌ Restore theme_mode failed:', err); });
-      }
+    var tmVal = getSetting('theme_mode');
+    if (tmVal !== null) {
+      Pebble.sendAppMessage({ 'theme_mode': tmVal }, function(){ console.log('✅ Restored theme_mode:', tmVal); }, function(err){ console.error('❌ Restore theme_mode failed:', err); });
     }
 
     // Date format
-    var df = localStorage.getItem('oura_date_format');
-    if (df !== null && df !== undefined) {
-      var dfVal = parseInt(df);
-      if (!isNaN(dfVal)) {
-        Pebble.sendAppMessage({ 'date_format': dfVal }, function(){ console.log('✅ Restored date_format:', dfVal); }, function(err){ console.error('❌ Restore date_format failed:', err); });
-      }
+    var dfVal = getSetting('date_format');
+    if (dfVal !== null) {
+      Pebble.sendAppMessage({ 'date_format': dfVal }, function(){ console.log('✅ Restored date_format:', dfVal); }, function(err){ console.error('❌ Restore date_format failed:', err); });
     }
 
     // Colors
@@ -1660,21 +1524,17 @@ Pebble.addEventListener('ready', function() {
     var colorMsg = {}; var haveAny = false;
     for (var i=0;i<colorKeys.length;i++) {
       var ck = colorKeys[i];
-      var stored = localStorage.getItem('oura_' + ck);
-      if (stored !== null && stored !== undefined && stored !== '') {
-        var cv = parseInt(stored);
-        if (!isNaN(cv)) { colorMsg[ck] = cv; haveAny = true; }
-      }
+      var cv = getSetting(ck);
+      if (cv !== null) { colorMsg[ck] = cv; haveAny = true; }
     }
     if (haveAny) {
       enqueueMessage(colorMsg, function(){ console.log('✅ Restored colors:', colorMsg); }, function(err){ console.error('❌ Restore colors failed:', err); });
     }
 
     // Layout
-    var layoutJson = localStorage.getItem('oura_measurement_layout');
-    if (layoutJson) {
+    var lc = getSetting('measurement_layout');
+    if (lc) {
       try {
-        var lc = JSON.parse(layoutJson);
         var lmsg = {};
         if (lc.left !== undefined) lmsg.layout_left = parseInt(lc.left);
         if (lc.middle !== undefined) lmsg.layout_middle = parseInt(lc.middle);
@@ -1691,11 +1551,14 @@ Pebble.addEventListener('ready', function() {
     console.error('❌ Error during settings rehydrate:', rehErr);
   }
 
-  // Check if we have a valid token and fetch data
+  // Persist a migrated or day-rolled state before the first fetch
+  flushState();
+
+  // The watch asks for its stale sources (request_data + stale_mask) at launch
+  // and again on our first message if that request found JS not yet running
   if (CONFIG_SETTINGS.connected && CONFIG_SETTINGS.access_token) {
-    console.log('Valid token found in CONFIG_SETTINGS, fetching Oura data');
+    console.log('Valid token found in CONFIG_SETTINGS, waiting for watch request');
     sendDebugStatus('Token found, loading data...');
-    fetchAllOuraData();
   } else {
     console.log('No valid token found in CONFIG_SETTINGS');
     sendDebugStatus('Please configure in Pebble app');
@@ -1708,16 +1571,15 @@ Pebble.addEventListener('appmessage', function(e) {
   if (e.payload.request_data) {
     // Ensure show_loading is sent right before data fetch cycle
     try {
-      var slPrefNow = localStorage.getItem('oura_show_loading');
-      // Config page stores '1'/'0', default to false if not set
-      var slNow = (slPrefNow === '1');
+      var slNow = getSetting('show_loading');
       Pebble.sendAppMessage({ 'show_loading': slNow ? 1 : 0 }, function() {
         console.log('✅ show_loading re-sent on request_data:', slNow ? 1 : 0);
       }, function(err) {
         console.error('❌ Error re-sending show_loading on request_data:', err);
       });
     } catch (e2) { console.log('Error re-sending show_loading:', e2); }
-    fetchAllOuraData();
+    // Older watch builds send no stale_mask: fetch everything for them
+    fetchAllOuraData(e.payload.stale_mask);
   }
   
   if (e.payload.setup_auth) {
@@ -1754,7 +1616,9 @@ Pebble.addEventListener('webviewclosed', function(e) {
       sendDebugStatus('Settings received: ' + Object.keys(settings).join(', '));
       
       // Check if we got a token
+      var newToken = false;
       if (settings.oura_access_token) {
+        newToken = settings.oura_access_token !== localStorage.getItem('oura_access_token');
         console.log('🔐 New token received:', settings.oura_access_token.substring(0, 10) + '...');
         sendDebugStatus('New token received');
         
@@ -1773,7 +1637,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
         console.log('📊 Layout configuration received:', settings.layout_left, settings.layout_middle, settings.layout_right);
         sendDebugStatus('Layout config received');
         
-        // Store layout configuration in localStorage (config page already saved it, but ensure consistency)
+        // Store layout configuration in the phone state
         var layoutConfig = {
           left: settings.layout_left.toString(),
           middle: settings.layout_middle.toString(),
@@ -1785,8 +1649,8 @@ Pebble.addEventListener('webviewclosed', function(e) {
         };
         console.log('💾 Storing layout config:', JSON.stringify(layoutConfig));
         console.log('🔍 Flexible layout fields - rows:', layoutConfig.rows, 'row2_left:', layoutConfig.row2_left, 'row2_right:', layoutConfig.row2_right);
-        localStorage.setItem('oura_measurement_layout', JSON.stringify(layoutConfig));
-        console.log('✅ Layout configuration stored in localStorage');
+        setSetting('measurement_layout', layoutConfig);
+        console.log('✅ Layout configuration stored');
         sendDebugStatus('Layout config stored');
 
         // Send layout settings to watchface immediately
@@ -1824,7 +1688,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
         sendDebugStatus('Date format config received');
         
         // Store date format configuration
-        localStorage.setItem('oura_date_format', settings.date_format.toString());
+        setSetting('date_format', settings.date_format);
         console.log('💾 Date format stored:', settings.date_format);
         sendDebugStatus('Date format stored');
         
@@ -1851,7 +1715,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
         sendDebugStatus('Theme mode config received');
         
         // Store theme mode configuration
-        localStorage.setItem('oura_theme_mode', settings.theme_mode.toString());
+        setSetting('theme_mode', settings.theme_mode);
         console.log('💾 Theme mode stored:', settings.theme_mode);
         sendDebugStatus('Theme mode stored');
         
@@ -1894,7 +1758,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
               colorMessage[ck] = v;
               anyColor = true;
               // Persist on phone for consistency (watch persists separately)
-              try { localStorage.setItem('oura_' + ck, String(v)); } catch (e3) {}
+              setSetting(ck, v);
             }
           }
         }
@@ -1917,7 +1781,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
       if (settings.use_emoji !== undefined && settings.use_emoji !== null) {
         try {
           var ue = (settings.use_emoji === 1 || settings.use_emoji === '1' || settings.use_emoji === true);
-          localStorage.setItem('oura_use_emoji', ue ? '1' : '0');
+          setSetting('use_emoji', ue);
           Pebble.sendAppMessage({ 'use_emoji': ue ? 1 : 0 }, function() {
             console.log('✅ use_emoji sent to watchface:', ue ? 1 : 0);
           }, function(err) {
@@ -1938,7 +1802,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
           if (settings.custom_color_name) colorObj.name = settings.custom_color_name;
           if (settings.custom_color_hex) colorObj.hex = settings.custom_color_hex;
           if (settings.custom_color_pebble) colorObj.pebble = settings.custom_color_pebble;
-          localStorage.setItem('oura_custom_color', JSON.stringify(colorObj));
+          setSetting('custom_color', colorObj);
           console.log('💾 Stored custom color selection:', JSON.stringify(colorObj));
 
           // Send to watch immediately
@@ -1961,33 +1825,16 @@ Pebble.addEventListener('webviewclosed', function(e) {
         console.log('🔄 Applying new layout immediately...');
         sendDebugStatus('Applying new layout');
         
-        // Get current cached data and resend with new layout
-        console.log('🔍 Getting cached data...');
-        var cachedData = getCachedOuraData();
-        console.log('📊 Cached data result:', cachedData ? 'Found' : 'None');
-        
-        if (cachedData && (cachedData.readiness || cachedData.sleep || cachedData.heart_rate)) {
-          console.log('📊 Resending cached data with new layout');
-          sendDebugStatus('Resending cached data');
-          try {
-            sendDataToWatch(cachedData);
-            console.log('✅ Data sent to watch with new layout');
-            sendDebugStatus('Layout applied successfully');
-          } catch (error) {
-            console.error('❌ Error sending data to watch:', error);
-            sendDebugStatus('Error applying layout: ' + error.message);
-          }
-        } else {
-          // If no cached data, fetch fresh data to apply new layout
-          console.log('🔄 No cached data, fetching fresh data for new layout');
-          sendDebugStatus('Fetching fresh data for layout');
-          try {
-            fetchAllOuraData();
-          } catch (error) {
-            console.error('❌ Error fetching fresh data:', error);
-            sendDebugStatus('Error fetching data: ' + error.message);
-          }
-        }
+        // Settings only: no metrics packet and no payload_complete, so the
+        // watch keeps its values and any request it has in flight stays open
+        var layoutSettings = appendWatchSettings({});
+        enqueueMessage(layoutSettings, function() {
+          console.log('✅ Watch settings sent with new layout');
+          sendDebugStatus('Layout applied successfully');
+        }, function(err) {
+          console.error('❌ Error sending watch settings:', err);
+          sendDebugStatus('Error applying layout');
+        });
       } else {
         console.log('⚠️ Layout configuration not found in settings');
         sendDebugStatus('No layout config in settings');
@@ -1997,7 +1844,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
       if (settings.show_debug !== undefined && settings.show_debug !== null) {
         try {
           var sd = !!settings.show_debug;
-          localStorage.setItem('oura_show_debug', sd ? 'true' : 'false');
+          setSetting('show_debug', sd);
           CONFIG_SETTINGS.show_debug = sd;
           Pebble.sendAppMessage({ 'show_debug': sd ? 1 : 0 }, function() {
             console.log('✅ show_debug sent to watchface:', sd ? 1 : 0);
@@ -2013,7 +1860,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
       if (settings.show_seconds !== undefined && settings.show_seconds !== null) {
         try {
           var ss = (settings.show_seconds === 1 || settings.show_seconds === '1' || settings.show_seconds === true);
-          localStorage.setItem('oura_show_seconds', ss ? '1' : '0');
+          setSetting('show_seconds', ss);
           CONFIG_SETTINGS.show_seconds = ss;
           Pebble.sendAppMessage({ 'show_seconds': ss ? 1 : 0 }, function() {
             console.log('✅ show_seconds sent to watchface:', ss ? 1 : 0);
@@ -2029,7 +1876,7 @@ Pebble.addEventListener('webviewclosed', function(e) {
       if (settings.compact_time !== undefined && settings.compact_time !== null) {
         try {
           var ct = (settings.compact_time === 1 || settings.compact_time === '1' || settings.compact_time === true);
-          localStorage.setItem('oura_compact_time', ct ? '1' : '0');
+          setSetting('compact_time', ct);
           CONFIG_SETTINGS.compact_time = ct;
           Pebble.sendAppMessage({ 'compact_time': ct ? 1 : 0 }, function() {
             console.log('✅ compact_time sent to watchface:', ct ? 1 : 0);
@@ -2046,15 +1893,13 @@ Pebble.addEventListener('webviewclosed', function(e) {
         try {
           var rf = parseInt(settings.refresh_frequency) || 30;
           if (rf !== 15 && rf !== 30 && rf !== 60) rf = 30;
-          localStorage.setItem('oura_refresh_frequency', String(rf));
+          setSetting('refresh_frequency', rf);
           CONFIG_SETTINGS.refresh_frequency = rf;
           Pebble.sendAppMessage({ 'refresh_frequency': rf }, function() {
             console.log('✅ refresh_frequency sent to watchface:', rf);
           }, function(err) {
             console.error('❌ Error sending refresh_frequency:', err);
           });
-          // Apply new interval to phone-side fetch timer
-          updateRefreshInterval();
         } catch (e2) {
           console.error('❌ Error handling refresh_frequency:', e2);
         }
@@ -2069,18 +1914,18 @@ Pebble.addEventListener('webviewclosed', function(e) {
       }
       
       // Store settings for persistence
-      localStorage.setItem('oura_config_settings', JSON.stringify(CONFIG_SETTINGS));
+      flushState();
       console.log('⚙️ Config settings updated and stored');
       
-      // Update periodic refresh interval if changed
-      updateRefreshInterval();
-      
-      // Check what token we have now
+      // Only a new token warrants a full fetch; layout, colors and toggles
+      // leave the data as it is and the watch keeps asking for stale sources
       var currentToken = getStoredToken();
-      if (currentToken) {
-        console.log('✅ Current token available:', currentToken.substring(0, 10) + '...');
+      if (currentToken && newToken) {
+        console.log('✅ New token available:', currentToken.substring(0, 10) + '...');
         sendDebugStatus('Token available - fetching data');
         fetchAllOuraData();
+      } else if (currentToken) {
+        console.log('✅ Token unchanged, no refetch');
       } else {
         console.log('❌ No token available after config');
         sendDebugStatus('No token available');
@@ -2099,35 +1944,9 @@ Pebble.addEventListener('webviewclosed', function(e) {
 // =============================================================================
 // PERIODIC DATA UPDATES
 // =============================================================================
-
-// Dynamic refresh interval (will be updated by config)
-var refreshIntervalId = null;
-
-function updateRefreshInterval() {
-  // Clear existing interval
-  if (refreshIntervalId) {
-    clearInterval(refreshIntervalId);
-  }
-  
-  // Set new interval based on config
-  var refreshMinutes = CONFIG_SETTINGS.refresh_frequency || 30;
-  var refreshMs = refreshMinutes * 60 * 1000;
-  
-  console.log('Setting refresh interval to', refreshMinutes, 'minutes');
-  
-  refreshIntervalId = setInterval(function() {
-    var lastUpdate = localStorage.getItem(STORAGE_KEYS.LAST_UPDATE);
-    var refreshAgo = Date.now() - refreshMs;
-    
-    if (!lastUpdate || parseInt(lastUpdate) < refreshAgo) {
-      console.log('Periodic Oura data update (' + refreshMinutes + ' min interval)');
-      fetchAllOuraData();
-    }
-  }, refreshMs);
-}
-
-// Initialize refresh interval
-updateRefreshInterval();
+// The watch schedules refreshes (refresh_frequency, failure backoff, night
+// stretching) and asks with request_data plus the mask of stale sources, so
+// the phone keeps no timer of its own.
 
 // =============================================================================
 // UTILITY FUNCTIONS
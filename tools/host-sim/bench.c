@@ -0,0 +1,522 @@
+// =============================================================================
+// HOST SIMULATION: inbox replay benchmark
+// =============================================================================
+// Replays the recorded-shape payloads in corpus/*.msgs through
+// inbox_received_callback and reports, per payload and per message, the wall
+// time to handle a message (callback plus the redraw it schedules) and the
+// work it caused: heap allocations, text/layer calls, frames, persist writes.
+// Results are compared against bench_baseline.txt; more work than the
+// baseline, or a message that got slower than the tolerance allows, fails.
+//
+//   build/bench [--update] [--tolerance PCT] [--no-timing] [--verbose] [--baseline FILE] corpus/*.msgs
+//
+// Corpus format, one tuple per line, '#' starts a comment:
+//   message [repeat N]        start a message (N identical copies)
+//   <type> <key> <value>      type: int int8 int16 uint8 uint16 uint32 cstring
+//                             chars (no NUL) bytes (hex); key: name or #number
+// A value may list two alternatives "a|b"; iterations alternate between them
+// so settings really change on every replay.
+
+#define main watchface_main
+#include "../../src/c/oura-stats-watchface.c"
+#undef main
+// The bench's own bookkeeping stays off the simulated app heap
+#undef malloc
+#undef free
+#undef time
+
+#include "sim_phone.h"
+
+#include <ctype.h>
+#include <errno.h>
+
+#define BENCH_MAX_PAYLOADS    32
+#define BENCH_MAX_MESSAGES    64
+#define BENCH_MAX_TUPLES      16
+#define BENCH_MAX_VALUE       256
+#define BENCH_ROUNDS          5
+#define BENCH_ITERATIONS      40      // per round; even, so both alternatives run equally
+#define BENCH_MESSAGE_GAP_MS  100     // phone-side queue spacing between messages
+#define BENCH_SETTLE_MS       15000   // lets deferred work (settings flush, debug clear) land
+#define BENCH_DEFAULT_TOLERANCE 50    // percent over the baseline ns/msg that fails
+#define BENCH_TIMING_SLACK_NS 250     // ...but never less than this, so tiny timings don't flap
+
+typedef struct {
+  uint32_t key;
+  TupleType type;
+  uint8_t alternatives;
+  uint16_t length[2];
+  uint8_t data[2][BENCH_MAX_VALUE];
+} BenchTuple;
+
+typedef struct {
+  BenchTuple tuples[BENCH_MAX_TUPLES];
+  int count;
+} BenchMessage;
+
+typedef struct {
+  char name[40];
+  BenchMessage *messages;
+  int count;
+} BenchPayload;
+
+typedef struct {
+  char name[40];
+  uint32_t messages;          // per iteration
+  uint64_t ns_per_message;    // fastest round
+  SimCounters work;           // totals over all rounds
+  size_t heap_peak;
+  long heap_growth;           // heap after the last round minus after the first
+} BenchResult;
+
+static BenchPayload s_payloads[BENCH_MAX_PAYLOADS];
+static int s_payload_count = 0;
+
+// =============================================================================
+// CORPUS PARSER
+// =============================================================================
+
+static int s_line_number = 0;
+static const char *s_corpus_path = NULL;
+
+static void corpus_error(const char *message) {
+  fprintf(stderr, "%s:%d: %s\n", s_corpus_path, s_line_number, message);
+  exit(2);
+}
+
+static uint32_t parse_key(const char *name) {
+  if (name[0] == '#') {
+    return (uint32_t)strtoul(name + 1, NULL, 10);
+  }
+  for (int i = 0; i < g_sim_message_key_count; i++) {
+    if (strcmp(g_sim_message_key_names[i].name, name) == 0) {
+      return *g_sim_message_key_names[i].key;
+    }
+  }
+  corpus_error("unknown message key");
+  return 0;
+}
+
+static uint16_t parse_hex(const char *text, uint8_t *out) {
+  uint16_t length = 0;
+  while (isxdigit((unsigned char)text[0]) && isxdigit((unsigned char)text[1])) {
+    if (length == BENCH_MAX_VALUE) {
+      corpus_error("byte value too long");
+    }
+    char byte[3] = { text[0], text[1], '\0' };
+    out[length++] = (uint8_t)strtoul(byte, NULL, 16);
+    text += 2;
+  }
+  if (*text) {
+    corpus_error("bad hex byte value");
+  }
+  return length;
+}
+
+static uint16_t parse_value(const char *type, const char *text, uint8_t *out, TupleType *tuple_type) {
+  if (strcmp(type, "cstring") == 0 || strcmp(type, "chars") == 0) {
+    size_t length = strlen(text);
+    bool terminated = type[1] == 's';
+    if (length + terminated > BENCH_MAX_VALUE) {
+      corpus_error("string value too long");
+    }
+    memcpy(out, text, length + terminated);
+    *tuple_type = TUPLE_CSTRING;
+    return (uint16_t)(length + terminated);
+  }
+  if (strcmp(type, "bytes") == 0) {
+    *tuple_type = TUPLE_BYTE_ARRAY;
+    return parse_hex(text, out);
+  }
+  static const struct { const char *name; TupleType type; uint16_t width; } k_int_types[] = {
+    { "int", TUPLE_INT, 4 }, { "int8", TUPLE_INT, 1 }, { "int16", TUPLE_INT, 2 },
+    { "uint8", TUPLE_UINT, 1 }, { "uint16", TUPLE_UINT, 2 }, { "uint32", TUPLE_UINT, 4 },
+  };
+  for (size_t i = 0; i < sizeof(k_int_types) / sizeof(k_int_types[0]); i++) {
+    if (strcmp(type, k_int_types[i].name) == 0) {
+      char *end;
+      errno = 0;
+      long long value = strtoll(text, &end, 0);
+      if (errno || *end || end == text) {
+        corpus_error("bad integer value");
+      }
+      for (uint16_t b = 0; b < k_int_types[i].width; b++) {
+        out[b] = (uint8_t)((unsigned long long)value >> (8 * b));  // little endian, as on the wire
+      }
+      *tuple_type = k_int_types[i].type;
+      return k_int_types[i].width;
+    }
+  }
+  corpus_error("unknown tuple type");
+  return 0;
+}
+
+static void parse_tuple(char *line, BenchMessage *message) {
+  char *type = strtok(line, " \t");
+  char *key = strtok(NULL, " \t");
+  char *value = strtok(NULL, "");
+  if (!type || !key) {
+    corpus_error("expected: <type> <key> <value>");
+  }
+  if (message->count == BENCH_MAX_TUPLES) {
+    corpus_error("too many tuples in message");
+  }
+  BenchTuple *tuple = &message->tuples[message->count++];
+  memset(tuple, 0, sizeof(*tuple));
+  tuple->key = parse_key(key);
+  value = value ? value : "";
+  char *split = strchr(value, '|');
+  if (split) {
+    *split = '\0';
+  }
+  tuple->length[0] = parse_value(type, value, tuple->data[0], &tuple->type);
+  tuple->alternatives = 1;
+  if (split) {
+    tuple->length[1] = parse_value(type, split + 1, tuple->data[1], &tuple->type);
+    tuple->alternatives = 2;
+  }
+}
+
+static void load_payload(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    fprintf(stderr, "cannot open %s\n", path);
+    exit(2);
+  }
+  if (s_payload_count == BENCH_MAX_PAYLOADS) {
+    fprintf(stderr, "too many payloads\n");
+    exit(2);
+  }
+  BenchPayload *payload = &s_payloads[s_payload_count++];
+  const char *base = strrchr(path, '/');
+  snprintf(payload->name, sizeof(payload->name), "%.39s", base ? base + 1 : path);
+  char *dot = strrchr(payload->name, '.');
+  if (dot) {
+    *dot = '\0';
+  }
+  payload->messages = calloc(BENCH_MAX_MESSAGES, sizeof(BenchMessage));
+  s_corpus_path = path;
+  s_line_number = 0;
+
+  char line[1024];
+  int repeat = 0;
+  while (fgets(line, sizeof(line), file)) {
+    s_line_number++;
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] == '#' || line[0] == '\0') {
+      continue;
+    }
+    if (strncmp(line, "message", 7) == 0) {
+      // Close the previous message by copying it for "repeat N"
+      for (int i = 1; i < repeat; i++) {
+        payload->messages[payload->count] = payload->messages[payload->count - 1];
+        payload->count++;
+      }
+      repeat = 1;
+      sscanf(line, "message repeat %d", &repeat);
+      if (repeat < 1 || payload->count + repeat > BENCH_MAX_MESSAGES) {
+        corpus_error("bad message count");
+      }
+      payload->messages[payload->count++].count = 0;
+      continue;
+    }
+    if (payload->count == 0) {
+      corpus_error("tuple before the first 'message'");
+    }
+    parse_tuple(line, &payload->messages[payload->count - 1]);
+  }
+  for (int i = 1; i < repeat; i++) {
+    payload->messages[payload->count] = payload->messages[payload->count - 1];
+    payload->count++;
+  }
+  fclose(file);
+}
+
+// =============================================================================
+// REPLAY
+// =============================================================================
+
+static uint64_t wall_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// One pass over the payload; returns the time spent handling its messages
+static uint64_t replay_once(const BenchPayload *payload, int iteration) {
+  uint64_t busy_ns = 0;
+  for (int m = 0; m < payload->count; m++) {
+    const BenchMessage *message = &payload->messages[m];
+    sim_dict_begin();
+    for (int i = 0; i < message->count; i++) {
+      const BenchTuple *tuple = &message->tuples[i];
+      int alt = iteration % tuple->alternatives;
+      sim_dict_add_tuple(tuple->key, tuple->type, tuple->data[alt], tuple->length[alt]);
+    }
+    // Handling cost: the callback, the frame it dirtied and the zero-delay
+    // render pass it scheduled
+    uint64_t start = wall_ns();
+    sim_inbox_deliver();
+    sim_run_for(0);
+    busy_ns += wall_ns() - start;
+    sim_run_for(BENCH_MESSAGE_GAP_MS);
+  }
+  sim_run_for(BENCH_SETTLE_MS);
+  return busy_ns;
+}
+
+static void replay_payload(const BenchPayload *payload, BenchResult *result) {
+  memset(result, 0, sizeof(*result));
+  memcpy(result->name, payload->name, sizeof(result->name));
+  result->messages = (uint32_t)payload->count;
+  result->ns_per_message = UINT64_MAX;
+  sim_heap_reset_peak();
+  SimCounters before = g_sim;
+  size_t heap_after_first = 0;
+  for (int round = 0; round < BENCH_ROUNDS; round++) {
+    uint64_t busy_ns = 0;
+    for (int i = 0; i < BENCH_ITERATIONS; i++) {
+      busy_ns += replay_once(payload, i);
+    }
+    uint64_t per_message = busy_ns / ((uint64_t)BENCH_ITERATIONS * (payload->count ? payload->count : 1));
+    if (per_message < result->ns_per_message) {
+      result->ns_per_message = per_message;
+    }
+    if (round == 0) {
+      heap_after_first = sim_heap_used();
+    }
+  }
+  result->work = sim_counters_diff(&before, &g_sim);
+  result->heap_peak = sim_heap_peak();
+  result->heap_growth = (long)sim_heap_used() - (long)heap_after_first;
+}
+
+// =============================================================================
+// BASELINE
+// =============================================================================
+
+// Work columns compared exactly: any increase is a regression
+#define BENCH_WORK_FIELDS(X) \
+  X(allocs) X(bytes_allocated) X(text_layer_set_text) X(layer_mark_dirty) \
+  X(text_measures) X(text_draws) X(frames) X(layer_updates) \
+  X(persist_writes) X(persist_bytes) X(timers) X(logs)
+
+static void write_baseline(const char *path, const BenchResult *results, int count) {
+  FILE *file = fopen(path, "w");
+  if (!file) {
+    fprintf(stderr, "cannot write %s\n", path);
+    exit(2);
+  }
+  fprintf(file, "# Inbox replay baseline, rewritten by `make bench-update`.\n");
+  fprintf(file, "# Work columns are totals over %d replays of each payload and must not grow;\n",
+          BENCH_ROUNDS * BENCH_ITERATIONS);
+  fprintf(file, "# ns_per_msg is host-specific and compared with a tolerance.\n");
+  fprintf(file, "replays %d\n", BENCH_ROUNDS * BENCH_ITERATIONS);
+  fprintf(file, "# payload messages ns_per_msg");
+#define X(field) fprintf(file, " %s", #field);
+  BENCH_WORK_FIELDS(X)
+#undef X
+  fprintf(file, "\n");
+  for (int i = 0; i < count; i++) {
+    const BenchResult *r = &results[i];
+    fprintf(file, "%s %u %llu", r->name, r->messages, (unsigned long long)r->ns_per_message);
+#define X(field) fprintf(file, " %u", r->work.field);
+    BENCH_WORK_FIELDS(X)
+#undef X
+    fprintf(file, "\n");
+  }
+  fclose(file);
+  printf("\nbaseline written to %s\n", path);
+}
+
+static bool read_baseline_entry(FILE *file, BenchResult *entry) {
+  char line[512];
+  while (fgets(line, sizeof(line), file)) {
+    if (line[0] == '#' || strncmp(line, "replays", 7) == 0 || line[0] == '\n') {
+      continue;
+    }
+    memset(entry, 0, sizeof(*entry));
+    unsigned long long ns = 0;
+    int used = 0;
+    if (sscanf(line, "%39s %u %llu%n", entry->name, &entry->messages, &ns, &used) != 3) {
+      continue;
+    }
+    entry->ns_per_message = ns;
+    char *cursor = line + used;
+#define X(field) entry->work.field = (uint32_t)strtoul(cursor, &cursor, 10);
+    BENCH_WORK_FIELDS(X)
+#undef X
+    return true;
+  }
+  return false;
+}
+
+// Returns the number of regressions
+static int compare_baseline(const char *path, const BenchResult *results, int count,
+                            int tolerance, bool check_timing) {
+  FILE *file = fopen(path, "r");
+  if (!file) {
+    printf("\nREGRESSION: no baseline at %s (run `make bench-update`)\n", path);
+    return 1;
+  }
+  int replays = 0;
+  char line[512];
+  while (fgets(line, sizeof(line), file)) {
+    if (sscanf(line, "replays %d", &replays) == 1) {
+      break;
+    }
+  }
+  if (replays != BENCH_ROUNDS * BENCH_ITERATIONS) {
+    fclose(file);
+    printf("\nREGRESSION: baseline was recorded with %d replays, this build runs %d\n",
+           replays, BENCH_ROUNDS * BENCH_ITERATIONS);
+    return 1;
+  }
+  BenchResult baseline[BENCH_MAX_PAYLOADS];
+  int baseline_count = 0;
+  while (baseline_count < BENCH_MAX_PAYLOADS && read_baseline_entry(file, &baseline[baseline_count])) {
+    baseline_count++;
+  }
+  fclose(file);
+
+  int regressions = 0;
+  int improvements = 0;
+  printf("\n");
+  for (int i = 0; i < count; i++) {
+    const BenchResult *r = &results[i];
+    const BenchResult *b = NULL;
+    for (int j = 0; j < baseline_count; j++) {
+      if (strcmp(baseline[j].name, r->name) == 0) {
+        b = &baseline[j];
+      }
+    }
+    if (!b) {
+      printf("REGRESSION: %s has no baseline entry (run `make bench-update`)\n", r->name);
+      regressions++;
+      continue;
+    }
+    if (b->messages != r->messages) {
+      printf("REGRESSION: %s: %u messages, baseline has %u (corpus changed? run `make bench-update`)\n",
+             r->name, r->messages, b->messages);
+      regressions++;
+      continue;
+    }
+#define X(field) \
+    if (r->work.field > b->work.field) { \
+      printf("REGRESSION: %s: %s %u -> %u (+%.3f per message)\n", r->name, #field, \
+             b->work.field, r->work.field, \
+             (double)(r->work.field - b->work.field) / (BENCH_ROUNDS * BENCH_ITERATIONS * r->messages)); \
+      regressions++; \
+    } else if (r->work.field < b->work.field) { \
+      improvements++; \
+    }
+    BENCH_WORK_FIELDS(X)
+#undef X
+    uint64_t allowance = b->ns_per_message * (uint64_t)tolerance / 100;
+    uint64_t limit = b->ns_per_message + (allowance > BENCH_TIMING_SLACK_NS ? allowance : BENCH_TIMING_SLACK_NS);
+    if (check_timing && r->ns_per_message > limit) {
+      printf("REGRESSION: %s: %llu ns/msg, baseline %llu ns/msg (limit %llu)\n", r->name,
+             (unsigned long long)r->ns_per_message, (unsigned long long)b->ns_per_message,
+             (unsigned long long)limit);
+      regressions++;
+    }
+  }
+  if (regressions) {
+    printf("\n*** %d REGRESSION%s against %s ***\n", regressions, regressions == 1 ? "" : "S", path);
+  } else {
+    printf("OK: no regressions against %s%s\n", path,
+           improvements ? " (some counters improved: run `make bench-update` to lock them in)" : "");
+  }
+  return regressions;
+}
+
+// =============================================================================
+// REPORT
+// =============================================================================
+
+static double per(uint32_t total, const BenchResult *r) {
+  return (double)total / ((double)BENCH_ROUNDS * BENCH_ITERATIONS * (r->messages ? r->messages : 1));
+}
+
+static void print_results(const BenchResult *results, int count) {
+  printf("%-16s %4s %8s %7s %8s %7s %7s %7s %6s %6s %6s %6s\n",
+         "payload", "msgs", "us/msg", "alloc", "a_bytes", "setText", "dirty", "measure",
+         "frames", "p_wr", "p_byte", "heap^");
+  for (int i = 0; i < count; i++) {
+    const BenchResult *r = &results[i];
+    printf("%-16s %4u %8.2f %7.2f %8.1f %7.2f %7.2f %7.2f %6.2f %6.2f %6.1f %6zu\n",
+           r->name, r->messages, r->ns_per_message / 1000.0,
+           per(r->work.allocs, r), per(r->work.bytes_allocated, r),
+           per(r->work.text_layer_set_text, r), per(r->work.layer_mark_dirty, r),
+           per(r->work.text_measures, r), per(r->work.frames, r),
+           per(r->work.persist_writes, r), per(r->work.persist_bytes, r), r->heap_peak);
+    if (r->heap_growth > 0) {
+      printf("  warning: heap grew by %ld bytes between the first and last round\n", r->heap_growth);
+    }
+  }
+  printf("(per message, averaged over %d replays; us/msg is the fastest round; heap^ is peak bytes)\n",
+         BENCH_ROUNDS * BENCH_ITERATIONS);
+  for (int i = 0; i < count; i++) {
+    const BenchResult *r = &results[i];
+    if (strcmp(r->name, "config_push") == 0) {
+      double replays = BENCH_ROUNDS * BENCH_ITERATIONS;
+      printf("\nconfig push from the settings page: %u messages, %.1f us handling per push, "
+             "%.1f allocs, %.0f heap bytes, %.1f frames, %.1f persist writes (%.0f bytes)\n",
+             r->messages, r->ns_per_message * r->messages / 1000.0,
+             r->work.allocs / replays, r->work.bytes_allocated / replays, r->work.frames / replays,
+             r->work.persist_writes / replays, r->work.persist_bytes / replays);
+    }
+  }
+}
+
+// =============================================================================
+// MAIN
+// =============================================================================
+
+int main(int argc, char **argv) {
+  const char *baseline_path = "bench_baseline.txt";
+  bool update = false;
+  bool check_timing = true;
+  int tolerance = BENCH_DEFAULT_TOLERANCE;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--update") == 0) {
+      update = true;
+    } else if (strcmp(argv[i], "--verbose") == 0) {
+      sim_set_log_level(APP_LOG_LEVEL_DEBUG);
+    } else if (strcmp(argv[i], "--no-timing") == 0) {
+      check_timing = false;
+    } else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+      tolerance = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+      baseline_path = argv[++i];
+    } else {
+      load_payload(argv[i]);
+    }
+  }
+  if (s_payload_count == 0) {
+    fprintf(stderr, "usage: %s [--update] [--tolerance PCT] [--no-timing] [--verbose] [--baseline FILE] corpus/*.msgs\n", argv[0]);
+    return 2;
+  }
+
+  setenv("TZ", "UTC", 1);
+  tzset();
+  struct tm start = { .tm_year = 2026 - 1900, .tm_mon = 9, .tm_mday = 16, .tm_hour = 6 };
+  sim_set_time(mktime(&start));
+  // No phone answers requests, and clock ticks stay out of the measurements
+  init();
+  sim_set_ticks_enabled(false);
+  sim_run_for(BENCH_SETTLE_MS);
+
+  BenchResult results[BENCH_MAX_PAYLOADS];
+  for (int i = 0; i < s_payload_count; i++) {
+    replay_payload(&s_payloads[i], &results[i]);
+  }
+  deinit();
+
+  print_results(results, s_payload_count);
+  if (update) {
+    write_baseline(baseline_path, results, s_payload_count);
+    return 0;
+  }
+  return compare_baseline(baseline_path, results, s_payload_count, tolerance, check_timing) ? 1 : 0;
+}
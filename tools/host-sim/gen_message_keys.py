@@ -0,0 +1,27 @@
+#!/usr/bin/env python3
+"""Write message_keys.h/.c for the host build from package.json messageKeys.
+
+Keys are numbered from 10000 in declaration order, like the SDK build does.
+"""
+import json
+import os
+import sys
+
+package_json, out_dir = sys.argv[1], sys.argv[2]
+with open(package_json) as f:
+    keys = json.load(f)["pebble"]["messageKeys"]
+
+os.makedirs(out_dir, exist_ok=True)
+with open(os.path.join(out_dir, "message_keys.h"), "w") as f:
+    f.write("#pragma once\n#include <stdint.h>\n")
+    f.writelines("extern uint32_t MESSAGE_KEY_%s;\n" % key for key in keys)
+    f.write("\n// Name lookup for the replay corpus\n")
+    f.write("typedef struct { const char *name; const uint32_t *key; } SimMessageKeyName;\n")
+    f.write("extern const SimMessageKeyName g_sim_message_key_names[];\n")
+    f.write("extern const int g_sim_message_key_count;\n")
+with open(os.path.join(out_dir, "message_keys.c"), "w") as f:
+    f.write('#include "message_keys.h"\n')
+    f.writelines("uint32_t MESSAGE_KEY_%s = %d;\n" % (key, 10000 + i) for i, key in enumerate(keys))
+    f.write("\nconst SimMessageKeyName g_sim_message_key_names[] = {\n")
+    f.writelines('  { "%s", &MESSAGE_KEY_%s },\n' % (key, key) for key in keys)
+    f.write("};\nconst int g_sim_message_key_count = %d;\n" % len(keys))
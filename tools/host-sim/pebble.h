@@ -0,0 +1,347 @@
+// =============================================================================
+// HOST SIMULATION: pebble.h stand-in
+// =============================================================================
+// Just enough of the Pebble SDK surface for src/c/oura-stats-watchface.c to
+// compile on a desktop toolchain. Declarations follow the SDK; the behaviour
+// lives in pebble_fakes.c and the driver hooks in sim.h.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Platform: a color, rectangular, health-capable watch (basalt)
+#ifndef PBL_ROUND
+#define PBL_RECT 1
+#define PBL_IF_ROUND_ELSE(a, b) (b)
+#define PBL_IF_RECT_ELSE(a, b) (a)
+#else
+#define PBL_IF_ROUND_ELSE(a, b) (a)
+#define PBL_IF_RECT_ELSE(a, b) (b)
+#endif
+#define PBL_COLOR 1
+#define PBL_HEALTH 1
+#define PBL_PLATFORM_BASALT 1
+#define PBL_IF_COLOR_ELSE(a, b) (a)
+#define PBL_API_EXISTS(x) 1
+
+// -----------------------------------------------------------------------------
+// Graphics types
+// -----------------------------------------------------------------------------
+
+typedef struct Window Window;
+typedef struct Layer Layer;
+typedef struct TextLayer TextLayer;
+typedef struct GContext GContext;
+typedef struct AppTimer AppTimer;
+typedef struct SimFont *GFont;
+
+typedef struct { int16_t x, y; } GPoint;
+typedef struct { int16_t w, h; } GSize;
+typedef struct { GPoint origin; GSize size; } GRect;
+typedef union { uint8_t argb; } GColor8;
+typedef GColor8 GColor;
+
+#define GRect(x, y, w, h) ((GRect){{(x), (y)}, {(w), (h)}})
+#define GPoint(x, y) ((GPoint){(x), (y)})
+#define GSize(w, h) ((GSize){(w), (h)})
+#define GRectZero GRect(0, 0, 0, 0)
+#define GColorClear ((GColor8){.argb = 0})
+#define GColorBlack ((GColor8){.argb = 0xC0})
+#define GColorWhite ((GColor8){.argb = 0xFF})
+#define GColorOxfordBlue ((GColor8){.argb = 0xC1})
+#define GColorDukeBlue ((GColor8){.argb = 0xC2})
+#define GColorBlue ((GColor8){.argb = 0xC3})
+#define GColorDarkGreen ((GColor8){.argb = 0xC4})
+#define GColorMidnightGreen ((GColor8){.argb = 0xC5})
+#define GColorCobaltBlue ((GColor8){.argb = 0xC6})
+#define GColorBlueMoon ((GColor8){.argb = 0xC7})
+#define GColorIslamicGreen ((GColor8){.argb = 0xC8})
+#define GColorJaegerGreen ((GColor8){.argb = 0xC9})
+#define GColorTiffanyBlue ((GColor8){.argb = 0xCA})
+#define GColorVividCerulean ((GColor8){.argb = 0xCB})
+#define GColorGreen ((GColor8){.argb = 0xCC})
+#define GColorMalachite ((GColor8){.argb = 0xCD})
+#define GColorMediumSpringGreen ((GColor8){.argb = 0xCE})
+#define GColorCyan ((GColor8){.argb = 0xCF})
+#define GColorBulgarianRose ((GColor8){.argb = 0xD0})
+#define GColorImperialPurple ((GColor8){.argb = 0xD1})
+#define GColorIndigo ((GColor8){.argb = 0xD2})
+#define GColorElectricUltramarine ((GColor8){.argb = 0xD3})
+#define GColorArmyGreen ((GColor8){.argb = 0xD4})
+#define GColorDarkGray ((GColor8){.argb = 0xD5})
+#define GColorLiberty ((GColor8){.argb = 0xD6})
+#define GColorVeryLightBlue ((GColor8){.argb = 0xD7})
+#define GColorKellyGreen ((GColor8){.argb = 0xD8})
+#define GColorMayGreen ((GColor8){.argb = 0xD9})
+#define GColorCadetBlue ((GColor8){.argb = 0xDA})
+#define GColorPictonBlue ((GColor8){.argb = 0xDB})
+#define GColorBrightGreen ((GColor8){.argb = 0xDC})
+#define GColorScreaminGreen ((GColor8){.argb = 0xDD})
+#define GColorMediumAquamarine ((GColor8){.argb = 0xDE})
+#define GColorElectricBlue ((GColor8){.argb = 0xDF})
+#define GColorDarkCandyAppleRed ((GColor8){.argb = 0xE0})
+#define GColorJazzberryJam ((GColor8){.argb = 0xE1})
+#define GColorPurple ((GColor8){.argb = 0xE2})
+#define GColorVividViolet ((GColor8){.argb = 0xE3})
+#define GColorWindsorTan ((GColor8){.argb = 0xE4})
+#define GColorRoseVale ((GColor8){.argb = 0xE5})
+#define GColorPurpureus ((GColor8){.argb = 0xE6})
+#define GColorLavenderIndigo ((GColor8){.argb = 0xE7})
+#define GColorLimerick ((GColor8){.argb = 0xE8})
+#define GColorBrass ((GColor8){.argb = 0xE9})
+#define GColorLightGray ((GColor8){.argb = 0xEA})
+#define GColorBabyBlueEyes ((GColor8){.argb = 0xEB})
+#define GColorSpringBud ((GColor8){.argb = 0xEC})
+#define GColorInchworm ((GColor8){.argb = 0xED})
+#define GColorMintGreen ((GColor8){.argb = 0xEE})
+#define GColorCeleste ((GColor8){.argb = 0xEF})
+#define GColorRed ((GColor8){.argb = 0xF0})
+#define GColorFolly ((GColor8){.argb = 0xF1})
+#define GColorFashionMagenta ((GColor8){.argb = 0xF2})
+#define GColorMagenta ((GColor8){.argb = 0xF3})
+#define GColorOrange ((GColor8){.argb = 0xF4})
+#define GColorSunsetOrange ((GColor8){.argb = 0xF5})
+#define GColorBrilliantRose ((GColor8){.argb = 0xF6})
+#define GColorShockingPink ((GColor8){.argb = 0xF7})
+#define GColorChromeYellow ((GColor8){.argb = 0xF8})
+#define GColorRajah ((GColor8){.argb = 0xF9})
+#define GColorMelon ((GColor8){.argb = 0xFA})
+#define GColorRichBrilliantLavender ((GColor8){.argb = 0xFB})
+#define GColorYellow ((GColor8){.argb = 0xFC})
+#define GColorIcterine ((GColor8){.argb = 0xFD})
+#define GColorPastelYellow ((GColor8){.argb = 0xFE})
+
+typedef enum { GTextAlignmentLeft, GTextAlignmentCenter, GTextAlignmentRight } GTextAlignment;
+typedef enum { GTextOverflowModeWordWrap, GTextOverflowModeTrailingEllipsis, GTextOverflowModeFill } GTextOverflowMode;
+typedef enum { GCornerNone = 0, GCornersAll = 15 } GCornerMask;
+
+bool gcolor_equal(GColor8 a, GColor8 b);
+bool grect_equal(const GRect *a, const GRect *b);
+GPoint grect_center_point(const GRect *r);
+
+#define TRIG_MAX_RATIO 0xffff
+#define TRIG_MAX_ANGLE 0x10000
+#define DEG_TO_TRIGANGLE(angle) (((angle) * TRIG_MAX_ANGLE) / 360)
+int32_t sin_lookup(int32_t angle);
+int32_t cos_lookup(int32_t angle);
+
+// Font keys encode the pixel height the fakes use for text metrics
+#define FONT_KEY_GOTHIC_14 "GOTHIC_14"
+#define FONT_KEY_GOTHIC_14_BOLD "GOTHIC_14_BOLD"
+#define FONT_KEY_GOTHIC_18 "GOTHIC_18"
+#define FONT_KEY_GOTHIC_18_BOLD "GOTHIC_18_BOLD"
+#define FONT_KEY_GOTHIC_24 "GOTHIC_24"
+#define FONT_KEY_GOTHIC_24_BOLD "GOTHIC_24_BOLD"
+#define FONT_KEY_GOTHIC_28 "GOTHIC_28"
+#define FONT_KEY_GOTHIC_28_BOLD "GOTHIC_28_BOLD"
+#define FONT_KEY_BITHAM_30_BLACK "BITHAM_30_BLACK"
+#define FONT_KEY_BITHAM_34_MEDIUM_NUMBERS "BITHAM_34_MEDIUM_NUMBERS"
+#define FONT_KEY_BITHAM_42_BOLD "BITHAM_42_BOLD"
+#define FONT_KEY_LECO_20_BOLD_NUMBERS "LECO_20_BOLD_NUMBERS"
+#define FONT_KEY_LECO_26_BOLD_NUMBERS_AM_PM "LECO_26_BOLD_NUMBERS_AM_PM"
+#define FONT_KEY_LECO_32_BOLD_NUMBERS "LECO_32_BOLD_NUMBERS"
+#define FONT_KEY_LECO_36_BOLD_NUMBERS "LECO_36_BOLD_NUMBERS"
+#define FONT_KEY_LECO_38_BOLD_NUMBERS "LECO_38_BOLD_NUMBERS"
+#define FONT_KEY_LECO_42_NUMBERS "LECO_42_NUMBERS"
+GFont fonts_get_system_font(const char *font_key);
+
+// -----------------------------------------------------------------------------
+// Layers, windows, text
+// -----------------------------------------------------------------------------
+
+typedef void (*LayerUpdateProc)(Layer *layer, GContext *ctx);
+Layer *layer_create(GRect frame);
+Layer *layer_create_with_data(GRect frame, size_t data_size);
+void *layer_get_data(const Layer *layer);
+void layer_destroy(Layer *layer);
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc);
+void layer_add_child(Layer *parent, Layer *child);
+void layer_remove_from_parent(Layer *child);
+void layer_insert_below_sibling(Layer *layer, Layer *below_layer);
+void layer_mark_dirty(Layer *layer);
+GRect layer_get_bounds(const Layer *layer);
+GRect layer_get_frame(const Layer *layer);
+GRect layer_get_unobstructed_bounds(const Layer *layer);
+void layer_set_frame(Layer *layer, GRect frame);
+void layer_set_bounds(Layer *layer, GRect bounds);
+void layer_set_hidden(Layer *layer, bool hidden);
+bool layer_get_hidden(const Layer *layer);
+
+typedef void (*WindowHandler)(Window *window);
+typedef struct { WindowHandler load, appear, disappear, unload; } WindowHandlers;
+Window *window_create(void);
+void window_destroy(Window *window);
+Layer *window_get_root_layer(const Window *window);
+void window_set_background_color(Window *window, GColor color);
+void window_set_window_handlers(Window *window, WindowHandlers handlers);
+void window_stack_push(Window *window, bool animated);
+
+typedef void *ClickRecognizerRef;
+typedef void (*ClickHandler)(ClickRecognizerRef recognizer, void *context);
+typedef void (*ClickConfigProvider)(void *context);
+typedef enum { BUTTON_ID_BACK, BUTTON_ID_UP, BUTTON_ID_SELECT, BUTTON_ID_DOWN, NUM_BUTTONS } ButtonId;
+void window_set_click_config_provider(Window *window, ClickConfigProvider provider);
+void window_long_click_subscribe(ButtonId button, uint16_t delay_ms, ClickHandler down, ClickHandler up);
+void window_single_click_subscribe(ButtonId button, ClickHandler handler);
+
+TextLayer *text_layer_create(GRect frame);
+void text_layer_destroy(TextLayer *text_layer);
+Layer *text_layer_get_layer(TextLayer *text_layer);
+void text_layer_set_text(TextLayer *text_layer, const char *text);
+const char *text_layer_get_text(TextLayer *text_layer);
+void text_layer_set_background_color(TextLayer *text_layer, GColor color);
+void text_layer_set_text_color(TextLayer *text_layer, GColor color);
+void text_layer_set_font(TextLayer *text_layer, GFont font);
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment);
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode mode);
+GSize text_layer_get_content_size(TextLayer *text_layer);
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow, GTextAlignment alignment);
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow, GTextAlignment alignment, void *attributes);
+void graphics_context_set_fill_color(GContext *ctx, GColor color);
+void graphics_context_set_text_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_color(GContext *ctx, GColor color);
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t width);
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t radius, GCornerMask corners);
+void graphics_draw_line(GContext *ctx, GPoint a, GPoint b);
+void graphics_fill_circle(GContext *ctx, GPoint center, uint16_t radius);
+void graphics_draw_circle(GContext *ctx, GPoint center, uint16_t radius);
+void graphics_draw_pixel(GContext *ctx, GPoint point);
+
+// -----------------------------------------------------------------------------
+// Services
+// -----------------------------------------------------------------------------
+
+typedef enum { SECOND_UNIT = 1, MINUTE_UNIT = 2, HOUR_UNIT = 4, DAY_UNIT = 8, MONTH_UNIT = 16, YEAR_UNIT = 32 } TimeUnits;
+typedef void (*TickHandler)(struct tm *tick_time, TimeUnits units_changed);
+void tick_timer_service_subscribe(TimeUnits units, TickHandler handler);
+void tick_timer_service_unsubscribe(void);
+bool clock_is_24h_style(void);
+time_t time_start_of_today(void);
+
+typedef void (*AppTimerCallback)(void *data);
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *data);
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms);
+void app_timer_cancel(AppTimer *timer);
+
+typedef enum { TUPLE_BYTE_ARRAY = 0, TUPLE_CSTRING = 1, TUPLE_UINT = 2, TUPLE_INT = 3 } TupleType;
+typedef union {
+  uint8_t data[0];
+  char cstring[0];
+  uint8_t uint8;
+  uint16_t uint16;
+  uint32_t uint32;
+  int8_t int8;
+  int16_t int16;
+  int32_t int32;
+} TupleValue;
+typedef struct __attribute__((__packed__)) {
+  uint32_t key;
+  TupleType type:8;
+  uint16_t length;
+  TupleValue value[];
+} Tuple;
+typedef struct DictionaryIterator DictionaryIterator;
+typedef enum { DICT_OK = 0, DICT_NOT_ENOUGH_STORAGE = 2 } DictionaryResult;
+Tuple *dict_find(const DictionaryIterator *iter, uint32_t key);
+Tuple *dict_read_first(DictionaryIterator *iter);
+Tuple *dict_read_next(DictionaryIterator *iter);
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value);
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, uint32_t key, uint32_t value);
+DictionaryResult dict_write_int32(DictionaryIterator *iter, uint32_t key, int32_t value);
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, uint32_t key, const char *value);
+
+typedef enum {
+  APP_MSG_OK = 0, APP_MSG_SEND_TIMEOUT = 2, APP_MSG_SEND_REJECTED = 4,
+  APP_MSG_NOT_CONNECTED = 8, APP_MSG_BUSY = 64
+} AppMessageResult;
+typedef void (*AppMessageInboxReceived)(DictionaryIterator *iter, void *context);
+typedef void (*AppMessageInboxDropped)(AppMessageResult reason, void *context);
+typedef void (*AppMessageOutboxFailed)(DictionaryIterator *iter, AppMessageResult reason, void *context);
+typedef void (*AppMessageOutboxSent)(DictionaryIterator *iter, void *context);
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived callback);
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped callback);
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed callback);
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent callback);
+AppMessageResult app_message_open(uint32_t inbox_size, uint32_t outbox_size);
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iter);
+AppMessageResult app_message_outbox_send(void);
+
+#define PERSIST_DATA_MAX_LENGTH 256
+bool persist_exists(uint32_t key);
+int persist_get_size(uint32_t key);
+bool persist_read_bool(uint32_t key);
+int32_t persist_read_int(uint32_t key);
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size);
+int persist_write_bool(uint32_t key, bool value);
+int persist_write_int(uint32_t key, int32_t value);
+int persist_write_data(uint32_t key, const void *data, size_t size);
+int persist_delete(uint32_t key);
+
+typedef void (*ConnectionHandler)(bool connected);
+typedef struct { ConnectionHandler pebble_app_connection_handler; ConnectionHandler pebblekit_connection_handler; } ConnectionHandlers;
+void connection_service_subscribe(ConnectionHandlers handlers);
+void connection_service_unsubscribe(void);
+bool connection_service_peek_pebble_app_connection(void);
+
+typedef int32_t AnimationProgress;
+typedef void (*UnobstructedAreaWillChangeHandler)(GRect final_unobstructed_screen_area, void *context);
+typedef void (*UnobstructedAreaChangeHandler)(AnimationProgress progress, void *context);
+typedef void (*UnobstructedAreaDidChangeHandler)(void *context);
+typedef struct {
+  UnobstructedAreaWillChangeHandler will_change;
+  UnobstructedAreaChangeHandler change;
+  UnobstructedAreaDidChangeHandler did_change;
+} UnobstructedAreaHandlers;
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context);
+void unobstructed_area_service_unsubscribe(void);
+
+typedef int32_t HealthValue;
+typedef enum { HealthMetricStepCount, HealthMetricActiveSeconds, HealthMetricHeartRateBPM } HealthMetric;
+typedef enum {
+  HealthServiceAccessibilityMaskAvailable = 1, HealthServiceAccessibilityMaskNoPermission = 2
+} HealthServiceAccessibilityMask;
+typedef enum {
+  HealthEventSignificantUpdate, HealthEventMovementUpdate, HealthEventSleepUpdate,
+  HealthEventMetricAlert, HealthEventHeartRateUpdate
+} HealthEventType;
+typedef void (*HealthEventHandler)(HealthEventType event, void *context);
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t start, time_t end);
+HealthValue health_service_sum_today(HealthMetric metric);
+HealthValue health_service_peek_current_value(HealthMetric metric);
+bool health_service_events_subscribe(HealthEventHandler handler, void *context);
+bool health_service_events_unsubscribe(void);
+
+void vibes_short_pulse(void);
+void app_event_loop(void);
+size_t heap_bytes_used(void);
+size_t heap_bytes_free(void);
+
+typedef enum {
+  APP_LOG_LEVEL_ERROR = 1, APP_LOG_LEVEL_WARNING = 50, APP_LOG_LEVEL_INFO = 100,
+  APP_LOG_LEVEL_DEBUG = 200, APP_LOG_LEVEL_DEBUG_VERBOSE = 255
+} AppLogLevel;
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+#define APP_LOG(level, fmt, args...) app_log(level, __FILE__, __LINE__, fmt, ## args)
+
+// Generated from package.json messageKeys by the Makefile
+#include "message_keys.h"
+
+// The watchface sees simulated time and the counting heap
+time_t sim_time(time_t *out);
+void *sim_malloc(size_t size);
+void sim_free(void *ptr);
+#ifndef SIM_INTERNAL
+#define time(out) sim_time(out)
+#define malloc(size) sim_malloc(size)
+#define free(ptr) sim_free(ptr)
+#endif
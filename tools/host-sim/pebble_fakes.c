@@ -0,0 +1,1064 @@
+// =============================================================================
+// HOST SIMULATION: fake Pebble SDK
+// =============================================================================
+// In-memory implementations of the SDK calls the watchface makes. Layers form
+// a real tree that sim_render() walks, timers and ticks run on a simulated
+// clock, persist is a small key/value table, AppMessage dictionaries use the
+// SDK tuple layout. Every call the reports care about bumps g_sim.
+
+#define SIM_INTERNAL 1
+#include "sim.h"
+
+#include <math.h>
+#include <stdarg.h>
+
+#define SIM_HEAP_SIZE          (64 * 1024)   // basalt-sized app heap
+#define SIM_PERSIST_SLOTS      64
+#define SIM_DICT_SIZE          1024
+#define SIM_MAX_FONTS          32
+
+SimCounters g_sim;
+
+SimCounters sim_counters_diff(const SimCounters *a, const SimCounters *b) {
+  SimCounters d;
+  const uint32_t *pa = (const uint32_t *)a, *pb = (const uint32_t *)b;
+  uint32_t *pd = (uint32_t *)&d;
+  for (size_t i = 0; i < sizeof(SimCounters) / sizeof(uint32_t); i++) {
+    pd[i] = pb[i] - pa[i];
+  }
+  return d;
+}
+
+// =============================================================================
+// HEAP
+// =============================================================================
+// Size-prefixed blocks so frees can be accounted; SDK objects (layers, timers)
+// come from the same heap, as they do on the watch.
+
+static size_t s_heap_used = 0;
+static size_t s_heap_peak = 0;
+
+void *sim_malloc(size_t size) {
+  if (s_heap_used + size > SIM_HEAP_SIZE) {
+    return NULL;
+  }
+  size_t *block = malloc(sizeof(size_t) + size);
+  if (!block) {
+    return NULL;
+  }
+  *block = size;
+  s_heap_used += size;
+  if (s_heap_used > s_heap_peak) {
+    s_heap_peak = s_heap_used;
+  }
+  g_sim.allocs++;
+  g_sim.bytes_allocated += (uint32_t)size;
+  return block + 1;
+}
+
+void sim_free(void *ptr) {
+  if (!ptr) {
+    return;
+  }
+  size_t *block = (size_t *)ptr - 1;
+  s_heap_used -= *block;
+  free(block);
+}
+
+static void *sim_zalloc(size_t size) {
+  void *ptr = sim_malloc(size);
+  if (ptr) {
+    memset(ptr, 0, size);
+  }
+  return ptr;
+}
+
+size_t heap_bytes_used(void) { return s_heap_used; }
+size_t heap_bytes_free(void) { return SIM_HEAP_SIZE - s_heap_used; }
+size_t sim_heap_used(void) { return s_heap_used; }
+size_t sim_heap_peak(void) { return s_heap_peak; }
+void sim_heap_reset_peak(void) { s_heap_peak = s_heap_used; }
+
+// =============================================================================
+// LOGGING
+// =============================================================================
+
+static int s_log_level = 0;
+
+void sim_set_log_level(int level) {
+  s_log_level = level;
+}
+
+void app_log(uint8_t log_level, const char *src_filename, int src_line_number, const char *fmt, ...) {
+  g_sim.logs++;
+  if (log_level > s_log_level) {
+    return;
+  }
+  const char *base = strrchr(src_filename, '/');
+  printf("[%6llu.%03llu] %s:%d ", (unsigned long long)(sim_now_ms() / 1000),
+         (unsigned long long)(sim_now_ms() % 1000), base ? base + 1 : src_filename, src_line_number);
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  va_end(args);
+  putchar('\n');
+}
+
+// =============================================================================
+// GRAPHICS PRIMITIVES AND FONTS
+// =============================================================================
+
+struct SimFont {
+  const char *key;
+  int height;
+};
+
+static struct SimFont s_fonts[SIM_MAX_FONTS];
+static int s_font_count = 0;
+
+GFont fonts_get_system_font(const char *font_key) {
+  for (int i = 0; i < s_font_count; i++) {
+    if (strcmp(s_fonts[i].key, font_key) == 0) {
+      return &s_fonts[i];
+    }
+  }
+  if (s_font_count == SIM_MAX_FONTS) {
+    return &s_fonts[0];
+  }
+  // The pixel size is the first number in the key (GOTHIC_18_BOLD -> 18)
+  const char *digits = font_key;
+  while (*digits && (*digits < '0' || *digits > '9')) {
+    digits++;
+  }
+  struct SimFont *font = &s_fonts[s_font_count++];
+  font->key = font_key;
+  font->height = *digits ? atoi(digits) : 14;
+  return font;
+}
+
+bool gcolor_equal(GColor8 a, GColor8 b) { return a.argb == b.argb; }
+
+bool grect_equal(const GRect *a, const GRect *b) {
+  return a->origin.x == b->origin.x && a->origin.y == b->origin.y &&
+         a->size.w == b->size.w && a->size.h == b->size.h;
+}
+
+GPoint grect_center_point(const GRect *r) {
+  return GPoint(r->origin.x + r->size.w / 2, r->origin.y + r->size.h / 2);
+}
+
+int32_t sin_lookup(int32_t angle) {
+  return (int32_t)lround(sin(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+int32_t cos_lookup(int32_t angle) {
+  return (int32_t)lround(cos(angle * 2.0 * M_PI / TRIG_MAX_ANGLE) * TRIG_MAX_RATIO);
+}
+
+// Approximate metrics: glyphs are ~0.55em wide (emoji a full em), lines 1.2em
+static GSize measure_text(const char *text, GFont font, GRect box, GTextOverflowMode overflow) {
+  g_sim.text_measures++;
+  int height = font ? font->height : 14;
+  int width = 0;
+  for (const unsigned char *p = (const unsigned char *)(text ? text : ""); *p; p++) {
+    if ((*p & 0xC0) == 0x80) {
+      continue;  // UTF-8 continuation byte
+    }
+    width += *p >= 0xF0 ? height : (height * 55 + 50) / 100;
+  }
+  int line_height = height * 6 / 5;
+  int lines = 1;
+  if (overflow == GTextOverflowModeWordWrap && box.size.w > 0 && width > box.size.w) {
+    lines = (width + box.size.w - 1) / box.size.w;
+    width = box.size.w;
+  }
+  return GSize((int16_t)width, (int16_t)(width ? lines * line_height : 0));
+}
+
+GSize graphics_text_layout_get_content_size(const char *text, GFont font, GRect box,
+                                            GTextOverflowMode overflow, GTextAlignment alignment) {
+  return measure_text(text, font, box, overflow);
+}
+
+void graphics_draw_text(GContext *ctx, const char *text, GFont font, GRect box,
+                        GTextOverflowMode overflow, GTextAlignment alignment, void *attributes) {
+  g_sim.text_draws++;
+}
+
+void graphics_context_set_fill_color(GContext *ctx, GColor color) {}
+void graphics_context_set_text_color(GContext *ctx, GColor color) {}
+void graphics_context_set_stroke_color(GContext *ctx, GColor color) {}
+void graphics_context_set_stroke_width(GContext *ctx, uint8_t width) {}
+void graphics_fill_rect(GContext *ctx, GRect rect, uint16_t radius, GCornerMask corners) {}
+void graphics_draw_line(GContext *ctx, GPoint a, GPoint b) {}
+void graphics_fill_circle(GContext *ctx, GPoint center, uint16_t radius) {}
+void graphics_draw_circle(GContext *ctx, GPoint center, uint16_t radius) {}
+void graphics_draw_pixel(GContext *ctx, GPoint point) {}
+
+// =============================================================================
+// LAYERS AND WINDOWS
+// =============================================================================
+
+struct Layer {
+  GRect frame;
+  GRect bounds;
+  bool hidden;
+  LayerUpdateProc update_proc;
+  Layer *parent;
+  Layer *first_child;
+  Layer *next_sibling;
+  TextLayer *text_layer;      // owning TextLayer, if any
+  void *data;
+};
+
+struct TextLayer {
+  Layer layer;
+  const char *text;
+  GFont font;
+  GTextOverflowMode overflow;
+};
+
+struct Window {
+  Layer root;
+  WindowHandlers handlers;
+  ClickConfigProvider click_config;
+};
+
+struct GContext {
+  int unused;
+};
+
+static bool s_dirty = false;         // anything to draw at the end of this event
+static Window *s_top_window = NULL;
+static GRect s_screen = {{0, 0}, {144, 168}};
+static int16_t s_obstruction = 0;
+
+static void layer_init(Layer *layer, GRect frame) {
+  memset(layer, 0, sizeof(*layer));
+  layer->frame = frame;
+  layer->bounds = GRect(0, 0, frame.size.w, frame.size.h);
+}
+
+Layer *layer_create_with_data(GRect frame, size_t data_size) {
+  Layer *layer = sim_malloc(sizeof(Layer) + data_size);
+  if (!layer) {
+    return NULL;
+  }
+  layer_init(layer, frame);
+  if (data_size) {
+    layer->data = layer + 1;
+    memset(layer->data, 0, data_size);
+  }
+  return layer;
+}
+
+Layer *layer_create(GRect frame) {
+  return layer_create_with_data(frame, 0);
+}
+
+void *layer_get_data(const Layer *layer) {
+  return layer->data;
+}
+
+void layer_mark_dirty(Layer *layer) {
+  g_sim.layer_mark_dirty++;
+  s_dirty = true;
+}
+
+void layer_remove_from_parent(Layer *child) {
+  Layer *parent = child ? child->parent : NULL;
+  if (!parent) {
+    return;
+  }
+  for (Layer **link = &parent->first_child; *link; link = &(*link)->next_sibling) {
+    if (*link == child) {
+      *link = child->next_sibling;
+      break;
+    }
+  }
+  child->parent = NULL;
+  child->next_sibling = NULL;
+  layer_mark_dirty(parent);
+}
+
+void layer_destroy(Layer *layer) {
+  if (!layer) {
+    return;
+  }
+  layer_remove_from_parent(layer);
+  sim_free(layer);
+}
+
+void layer_set_update_proc(Layer *layer, LayerUpdateProc update_proc) {
+  layer->update_proc = update_proc;
+}
+
+void layer_add_child(Layer *parent, Layer *child) {
+  layer_remove_from_parent(child);
+  Layer **link = &parent->first_child;
+  while (*link) {
+    link = &(*link)->next_sibling;
+  }
+  *link = child;
+  child->parent = parent;
+  layer_mark_dirty(child);
+}
+
+void layer_insert_below_sibling(Layer *layer, Layer *below_layer) {
+  Layer *parent = below_layer->parent;
+  if (!parent) {
+    return;
+  }
+  layer_remove_from_parent(layer);
+  for (Layer **link = &parent->first_child; *link; link = &(*link)->next_sibling) {
+    if (*link == below_layer) {
+      layer->next_sibling = below_layer;
+      *link = layer;
+      break;
+    }
+  }
+  layer->parent = parent;
+  layer_mark_dirty(layer);
+}
+
+GRect layer_get_bounds(const Layer *layer) { return layer->bounds; }
+GRect layer_get_frame(const Layer *layer) { return layer->frame; }
+
+GRect layer_get_unobstructed_bounds(const Layer *layer) {
+  GRect bounds = layer->bounds;
+  bounds.size.h = (int16_t)(bounds.size.h - s_obstruction);
+  return bounds;
+}
+
+void layer_set_frame(Layer *layer, GRect frame) {
+  layer->frame = frame;
+  layer->bounds.size = frame.size;
+  layer_mark_dirty(layer);
+}
+
+void layer_set_bounds(Layer *layer, GRect bounds) {
+  layer->bounds = bounds;
+  layer_mark_dirty(layer);
+}
+
+void layer_set_hidden(Layer *layer, bool hidden) {
+  if (layer->hidden != hidden) {
+    layer->hidden = hidden;
+    layer_mark_dirty(layer);
+  }
+}
+
+bool layer_get_hidden(const Layer *layer) { return layer->hidden; }
+
+Window *window_create(void) {
+  Window *window = sim_zalloc(sizeof(Window));
+  if (window) {
+    layer_init(&window->root, s_screen);
+  }
+  return window;
+}
+
+void window_destroy(Window *window) {
+  if (!window) {
+    return;
+  }
+  if (window == s_top_window) {
+    if (window->handlers.unload) {
+      window->handlers.unload(window);
+    }
+    s_top_window = NULL;
+  }
+  sim_free(window);
+}
+
+Layer *window_get_root_layer(const Window *window) {
+  return (Layer *)&window->root;
+}
+
+void window_set_background_color(Window *window, GColor color) {
+  layer_mark_dirty(&window->root);
+}
+
+void window_set_window_handlers(Window *window, WindowHandlers handlers) {
+  window->handlers = handlers;
+}
+
+void window_set_click_config_provider(Window *window, ClickConfigProvider provider) {
+  window->click_config = provider;
+}
+
+// The window is loaded (and its click config applied) as it is pushed
+void window_stack_push(Window *window, bool animated) {
+  s_top_window = window;
+  if (window->handlers.load) {
+    window->handlers.load(window);
+  }
+  if (window->click_config) {
+    window->click_config(NULL);
+  }
+  if (window->handlers.appear) {
+    window->handlers.appear(window);
+  }
+  layer_mark_dirty(&window->root);
+}
+
+static ClickHandler s_select_click = NULL;
+
+void window_single_click_subscribe(ButtonId button, ClickHandler handler) {
+  if (button == BUTTON_ID_SELECT) {
+    s_select_click = handler;
+  }
+}
+
+void window_long_click_subscribe(ButtonId button, uint16_t delay_ms, ClickHandler down, ClickHandler up) {}
+
+void sim_press_select(void) {
+  if (s_select_click) {
+    s_select_click(NULL, NULL);
+    sim_render();
+  }
+}
+
+TextLayer *text_layer_create(GRect frame) {
+  TextLayer *text_layer = sim_zalloc(sizeof(TextLayer));
+  if (!text_layer) {
+    return NULL;
+  }
+  layer_init(&text_layer->layer, frame);
+  text_layer->layer.text_layer = text_layer;
+  text_layer->font = fonts_get_system_font(FONT_KEY_GOTHIC_14);
+  return text_layer;
+}
+
+void text_layer_destroy(TextLayer *text_layer) {
+  if (text_layer) {
+    layer_destroy(&text_layer->layer);
+  }
+}
+
+Layer *text_layer_get_layer(TextLayer *text_layer) {
+  return &text_layer->layer;
+}
+
+void text_layer_set_text(TextLayer *text_layer, const char *text) {
+  g_sim.text_layer_set_text++;
+  text_layer->text = text;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+const char *text_layer_get_text(TextLayer *text_layer) {
+  return text_layer->text;
+}
+
+void text_layer_set_background_color(TextLayer *text_layer, GColor color) {
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_color(TextLayer *text_layer, GColor color) {
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_font(TextLayer *text_layer, GFont font) {
+  text_layer->font = font;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_text_alignment(TextLayer *text_layer, GTextAlignment alignment) {
+  layer_mark_dirty(&text_layer->layer);
+}
+
+void text_layer_set_overflow_mode(TextLayer *text_layer, GTextOverflowMode mode) {
+  text_layer->overflow = mode;
+  layer_mark_dirty(&text_layer->layer);
+}
+
+GSize text_layer_get_content_size(TextLayer *text_layer) {
+  return measure_text(text_layer->text, text_layer->font, text_layer->layer.frame, text_layer->overflow);
+}
+
+// -----------------------------------------------------------------------------
+// Frame rendering: the firmware redraws the whole window when anything is dirty
+// -----------------------------------------------------------------------------
+
+static void render_layer(Layer *layer, GContext *ctx) {
+  if (layer->hidden) {
+    return;
+  }
+  if (layer->update_proc) {
+    g_sim.layer_updates++;
+    layer->update_proc(layer, ctx);
+  }
+  if (layer->text_layer && layer->text_layer->text && layer->text_layer->text[0]) {
+    g_sim.text_draws++;
+  }
+  for (Layer *child = layer->first_child; child; child = child->next_sibling) {
+    render_layer(child, ctx);
+  }
+}
+
+void sim_render(void) {
+  if (!s_dirty || !s_top_window) {
+    return;
+  }
+  s_dirty = false;
+  g_sim.frames++;
+  GContext ctx = {0};
+  render_layer(&s_top_window->root, &ctx);
+}
+
+// =============================================================================
+// CLOCK, TIMERS AND TICKS
+// =============================================================================
+
+struct AppTimer {
+  uint64_t fire_ms;
+  uint64_t seq;              // registration order breaks ties
+  AppTimerCallback callback;
+  SimEventFn event;          // driver event instead of an app timer
+  void *data;
+  AppTimer *next;
+};
+
+static uint64_t s_now_ms = 0;
+static uint64_t s_timer_seq = 0;
+static AppTimer *s_timers = NULL;
+static TickHandler s_tick_handler = NULL;
+static TimeUnits s_tick_units = 0;
+static struct tm s_last_tick_tm;
+static uint64_t s_next_tick_ms = 0;
+static bool s_ticks_enabled = true;
+
+time_t sim_time(time_t *out) {
+  time_t now = (time_t)(s_now_ms / 1000);
+  if (out) {
+    *out = now;
+  }
+  return now;
+}
+
+void sim_set_time(time_t now) {
+  s_now_ms = (uint64_t)now * 1000;
+  localtime_r(&now, &s_last_tick_tm);
+}
+
+time_t sim_now(void) { return (time_t)(s_now_ms / 1000); }
+uint64_t sim_now_ms(void) { return s_now_ms; }
+
+time_t time_start_of_today(void) {
+  time_t now = sim_now();
+  struct tm tm;
+  localtime_r(&now, &tm);
+  tm.tm_hour = tm.tm_min = tm.tm_sec = 0;
+  return mktime(&tm);
+}
+
+bool clock_is_24h_style(void) { return true; }
+
+static AppTimer *timer_add(uint32_t timeout_ms, AppTimerCallback callback, SimEventFn event, void *data) {
+  AppTimer *timer = callback ? sim_zalloc(sizeof(AppTimer)) : calloc(1, sizeof(AppTimer));
+  if (!timer) {
+    return NULL;
+  }
+  timer->fire_ms = s_now_ms + timeout_ms;
+  timer->seq = s_timer_seq++;
+  timer->callback = callback;
+  timer->event = event;
+  timer->data = data;
+  timer->next = s_timers;
+  s_timers = timer;
+  return timer;
+}
+
+static bool timer_unlink(AppTimer *timer) {
+  for (AppTimer **link = &s_timers; *link; link = &(*link)->next) {
+    if (*link == timer) {
+      *link = timer->next;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void timer_free(AppTimer *timer) {
+  if (timer->callback) {
+    sim_free(timer);
+  } else {
+    free(timer);
+  }
+}
+
+AppTimer *app_timer_register(uint32_t timeout_ms, AppTimerCallback callback, void *data) {
+  g_sim.timers++;
+  return timer_add(timeout_ms, callback, NULL, data);
+}
+
+bool app_timer_reschedule(AppTimer *timer, uint32_t new_timeout_ms) {
+  for (AppTimer *t = s_timers; t; t = t->next) {
+    if (t == timer) {
+      t->fire_ms = s_now_ms + new_timeout_ms;
+      return true;
+    }
+  }
+  return false;
+}
+
+void app_timer_cancel(AppTimer *timer) {
+  if (timer && timer_unlink(timer)) {
+    timer_free(timer);
+  }
+}
+
+void sim_schedule(uint32_t delay_ms, SimEventFn fn, void *data) {
+  timer_add(delay_ms, NULL, fn, data);
+}
+
+static uint64_t tick_step_ms(void) {
+  return (s_tick_units & SECOND_UNIT) ? 1000 : 60000;
+}
+
+void tick_timer_service_subscribe(TimeUnits units, TickHandler handler) {
+  s_tick_units = units;
+  s_tick_handler = handler;
+  s_next_tick_ms = (s_now_ms / tick_step_ms() + 1) * tick_step_ms();
+}
+
+void tick_timer_service_unsubscribe(void) {
+  s_tick_handler = NULL;
+  s_tick_units = 0;
+}
+
+static AppTimer *next_timer(void) {
+  AppTimer *best = NULL;
+  for (AppTimer *t = s_timers; t; t = t->next) {
+    if (!best || t->fire_ms < best->fire_ms || (t->fire_ms == best->fire_ms && t->seq < best->seq)) {
+      best = t;
+    }
+  }
+  return best;
+}
+
+// Next second or minute boundary the tick service fires on
+static uint64_t next_tick_ms(void) {
+  return s_tick_handler && s_ticks_enabled ? s_next_tick_ms : UINT64_MAX;
+}
+
+void sim_set_ticks_enabled(bool enabled) {
+  s_ticks_enabled = enabled;
+  s_next_tick_ms = (s_now_ms / tick_step_ms() + 1) * tick_step_ms();
+}
+
+static void fire_tick(void) {
+  time_t now = sim_now();
+  struct tm tm;
+  localtime_r(&now, &tm);
+  TimeUnits changed = SECOND_UNIT;
+  if (tm.tm_min != s_last_tick_tm.tm_min || tm.tm_hour != s_last_tick_tm.tm_hour) changed |= MINUTE_UNIT;
+  if (tm.tm_hour != s_last_tick_tm.tm_hour) changed |= HOUR_UNIT;
+  if (tm.tm_mday != s_last_tick_tm.tm_mday) changed |= DAY_UNIT;
+  if (tm.tm_mon != s_last_tick_tm.tm_mon) changed |= MONTH_UNIT;
+  if (tm.tm_year != s_last_tick_tm.tm_year) changed |= YEAR_UNIT;
+  s_last_tick_tm = tm;
+  s_next_tick_ms += tick_step_ms();
+  if (changed & s_tick_units) {
+    s_tick_handler(&tm, changed);
+  }
+}
+
+void sim_run_for(uint32_t ms) {
+  uint64_t end = s_now_ms + ms;
+  sim_render();
+  for (;;) {
+    AppTimer *timer = next_timer();
+    uint64_t timer_ms = timer ? timer->fire_ms : UINT64_MAX;
+    uint64_t tick_ms = next_tick_ms();
+    uint64_t at = timer_ms < tick_ms ? timer_ms : tick_ms;
+    if (at > end) {
+      break;
+    }
+    s_now_ms = at > s_now_ms ? at : s_now_ms;
+    if (timer_ms <= tick_ms) {
+      timer_unlink(timer);
+      if (timer->callback) {
+        timer->callback(timer->data);
+      } else {
+        timer->event(timer->data);
+      }
+      timer_free(timer);
+    } else {
+      fire_tick();
+    }
+    sim_render();
+  }
+  s_now_ms = end;
+}
+
+// =============================================================================
+// PERSISTENT STORAGE
+// =============================================================================
+
+typedef struct {
+  bool used;
+  uint32_t key;
+  uint16_t length;
+  uint8_t data[PERSIST_DATA_MAX_LENGTH];
+} PersistSlot;
+
+static PersistSlot s_persist[SIM_PERSIST_SLOTS];
+
+static PersistSlot *persist_find(uint32_t key, bool create) {
+  PersistSlot *free_slot = NULL;
+  for (int i = 0; i < SIM_PERSIST_SLOTS; i++) {
+    if (s_persist[i].used && s_persist[i].key == key) {
+      return &s_persist[i];
+    }
+    if (!s_persist[i].used && !free_slot) {
+      free_slot = &s_persist[i];
+    }
+  }
+  if (create && free_slot) {
+    free_slot->used = true;
+    free_slot->key = key;
+    free_slot->length = 0;
+    return free_slot;
+  }
+  return NULL;
+}
+
+bool persist_exists(uint32_t key) { return persist_find(key, false) != NULL; }
+
+int persist_get_size(uint32_t key) {
+  PersistSlot *slot = persist_find(key, false);
+  return slot ? slot->length : -1;
+}
+
+int persist_read_data(uint32_t key, void *buffer, size_t buffer_size) {
+  PersistSlot *slot = persist_find(key, false);
+  if (!slot) {
+    return -1;
+  }
+  size_t n = slot->length < buffer_size ? slot->length : buffer_size;
+  memcpy(buffer, slot->data, n);
+  return (int)n;
+}
+
+int32_t persist_read_int(uint32_t key) {
+  int32_t value = 0;
+  persist_read_data(key, &value, sizeof(value));
+  return value;
+}
+
+bool persist_read_bool(uint32_t key) {
+  return persist_read_int(key) != 0;
+}
+
+int persist_write_data(uint32_t key, const void *data, size_t size) {
+  if (size > PERSIST_DATA_MAX_LENGTH) {
+    size = PERSIST_DATA_MAX_LENGTH;
+  }
+  PersistSlot *slot = persist_find(key, true);
+  if (!slot) {
+    return -1;
+  }
+  g_sim.persist_writes++;
+  g_sim.persist_bytes += (uint32_t)size;
+  memcpy(slot->data, data, size);
+  slot->length = (uint16_t)size;
+  return (int)size;
+}
+
+int persist_write_int(uint32_t key, int32_t value) {
+  return persist_write_data(key, &value, sizeof(value));
+}
+
+int persist_write_bool(uint32_t key, bool value) {
+  return persist_write_int(key, value ? 1 : 0);
+}
+
+int persist_delete(uint32_t key) {
+  PersistSlot *slot = persist_find(key, false);
+  if (slot) {
+    slot->used = false;
+  }
+  return 0;
+}
+
+// =============================================================================
+// APPMESSAGE
+// =============================================================================
+
+struct DictionaryIterator {
+  uint8_t buffer[SIM_DICT_SIZE];
+  size_t used;
+  size_t cursor;
+};
+
+static DictionaryIterator s_inbox;
+static DictionaryIterator s_outbox;
+static AppMessageInboxReceived s_inbox_received = NULL;
+static AppMessageInboxDropped s_inbox_dropped = NULL;
+static AppMessageOutboxFailed s_outbox_failed = NULL;
+static AppMessageOutboxSent s_outbox_sent = NULL;
+static SimOutboxObserver s_outbox_observer = NULL;
+static uint32_t s_outbox_ack_ms = 100;
+static uint32_t s_inbox_size = 0;
+static bool s_outbox_in_flight = false;
+static bool s_phone_connected = true;
+
+static DictionaryResult dict_append(DictionaryIterator *iter, uint32_t key, TupleType type,
+                                    const void *data, uint16_t length) {
+  if (iter->used + sizeof(Tuple) + length > sizeof(iter->buffer)) {
+    return DICT_NOT_ENOUGH_STORAGE;
+  }
+  Tuple *t = (Tuple *)(iter->buffer + iter->used);
+  t->key = key;
+  t->type = type;
+  t->length = length;
+  memcpy(t->value->data, data, length);
+  iter->used += sizeof(Tuple) + length;
+  return DICT_OK;
+}
+
+Tuple *dict_read_first(DictionaryIterator *iter) {
+  iter->cursor = 0;
+  return dict_read_next(iter);
+}
+
+Tuple *dict_read_next(DictionaryIterator *iter) {
+  if (iter->cursor >= iter->used) {
+    return NULL;
+  }
+  Tuple *t = (Tuple *)(iter->buffer + iter->cursor);
+  iter->cursor += sizeof(Tuple) + t->length;
+  return t;
+}
+
+Tuple *dict_find(const DictionaryIterator *iter, uint32_t key) {
+  for (size_t at = 0; at < iter->used;) {
+    Tuple *t = (Tuple *)(iter->buffer + at);
+    if (t->key == key) {
+      return t;
+    }
+    at += sizeof(Tuple) + t->length;
+  }
+  return NULL;
+}
+
+DictionaryResult dict_write_uint8(DictionaryIterator *iter, uint32_t key, uint8_t value) {
+  return dict_append(iter, key, TUPLE_UINT, &value, 1);
+}
+
+DictionaryResult dict_write_uint32(DictionaryIterator *iter, uint32_t key, uint32_t value) {
+  return dict_append(iter, key, TUPLE_UINT, &value, 4);
+}
+
+DictionaryResult dict_write_int32(DictionaryIterator *iter, uint32_t key, int32_t value) {
+  return dict_append(iter, key, TUPLE_INT, &value, 4);
+}
+
+DictionaryResult dict_write_cstring(DictionaryIterator *iter, uint32_t key, const char *value) {
+  return dict_append(iter, key, TUPLE_CSTRING, value, (uint16_t)(strlen(value) + 1));
+}
+
+AppMessageInboxReceived app_message_register_inbox_received(AppMessageInboxReceived callback) {
+  AppMessageInboxReceived previous = s_inbox_received;
+  s_inbox_received = callback;
+  return previous;
+}
+
+AppMessageInboxDropped app_message_register_inbox_dropped(AppMessageInboxDropped callback) {
+  AppMessageInboxDropped previous = s_inbox_dropped;
+  s_inbox_dropped = callback;
+  return previous;
+}
+
+AppMessageOutboxFailed app_message_register_outbox_failed(AppMessageOutboxFailed callback) {
+  AppMessageOutboxFailed previous = s_outbox_failed;
+  s_outbox_failed = callback;
+  return previous;
+}
+
+AppMessageOutboxSent app_message_register_outbox_sent(AppMessageOutboxSent callback) {
+  AppMessageOutboxSent previous = s_outbox_sent;
+  s_outbox_sent = callback;
+  return previous;
+}
+
+AppMessageResult app_message_open(uint32_t inbox_size, uint32_t outbox_size) {
+  s_inbox_size = inbox_size;
+  return APP_MSG_OK;
+}
+
+AppMessageResult app_message_outbox_begin(DictionaryIterator **iter) {
+  if (s_outbox_in_flight) {
+    return APP_MSG_BUSY;
+  }
+  s_outbox.used = 0;
+  s_outbox.cursor = 0;
+  *iter = &s_outbox;
+  return APP_MSG_OK;
+}
+
+// The phone acks (or the send fails) after the configured round trip
+static void outbox_complete(void *data) {
+  s_outbox_in_flight = false;
+  if (!s_phone_connected) {
+    if (s_outbox_failed) {
+      s_outbox_failed(&s_outbox, APP_MSG_NOT_CONNECTED, NULL);
+    }
+    return;
+  }
+  if (s_outbox_observer) {
+    s_outbox_observer(&s_outbox);
+  }
+  if (s_outbox_sent) {
+    s_outbox_sent(&s_outbox, NULL);
+  }
+}
+
+AppMessageResult app_message_outbox_send(void) {
+  g_sim.outbox_sends++;
+  s_outbox_in_flight = true;
+  sim_schedule(s_outbox_ack_ms, outbox_complete, NULL);
+  return APP_MSG_OK;
+}
+
+void sim_set_outbox_observer(SimOutboxObserver observer) {
+  s_outbox_observer = observer;
+}
+
+void sim_set_outbox_ack_ms(uint32_t ms) {
+  s_outbox_ack_ms = ms;
+}
+
+void sim_dict_begin(void) {
+  s_inbox.used = 0;
+  s_inbox.cursor = 0;
+}
+
+void sim_dict_add_tuple(uint32_t key, TupleType type, const void *data, uint16_t length) {
+  dict_append(&s_inbox, key, type, data, length);
+}
+
+void sim_dict_add_int(uint32_t key, int32_t value) {
+  dict_append(&s_inbox, key, TUPLE_INT, &value, 4);
+}
+
+void sim_dict_add_uint8(uint32_t key, uint8_t value) {
+  dict_append(&s_inbox, key, TUPLE_UINT, &value, 1);
+}
+
+void sim_dict_add_cstring(uint32_t key, const char *value) {
+  dict_append(&s_inbox, key, TUPLE_CSTRING, value, (uint16_t)(strlen(value) + 1));
+}
+
+void sim_dict_add_bytes(uint32_t key, const uint8_t *data, uint16_t length) {
+  dict_append(&s_inbox, key, TUPLE_BYTE_ARRAY, data, length);
+}
+
+// Messages larger than the opened inbox are dropped, as on the watch
+void sim_inbox_deliver(void) {
+  if (s_inbox_size && s_inbox.used + 1 > s_inbox_size) {
+    if (s_inbox_dropped) {
+      s_inbox_dropped(APP_MSG_SEND_REJECTED, NULL);
+    }
+    return;
+  }
+  g_sim.inbox_messages++;
+  if (s_inbox_received) {
+    s_inbox_received(&s_inbox, NULL);
+  }
+  sim_render();
+}
+
+// =============================================================================
+// CONNECTION, HEALTH, UNOBSTRUCTED AREA, MISC
+// =============================================================================
+
+static ConnectionHandler s_connection_handler = NULL;
+
+void connection_service_subscribe(ConnectionHandlers handlers) {
+  s_connection_handler = handlers.pebble_app_connection_handler;
+}
+
+void connection_service_unsubscribe(void) {
+  s_connection_handler = NULL;
+}
+
+bool connection_service_peek_pebble_app_connection(void) {
+  return s_phone_connected;
+}
+
+void sim_set_phone_connected(bool connected) {
+  if (s_phone_connected == connected) {
+    return;
+  }
+  s_phone_connected = connected;
+  if (s_connection_handler) {
+    s_connection_handler(connected);
+  }
+  sim_render();
+}
+
+static HealthEventHandler s_health_handler = NULL;
+static int s_health_steps = -1;
+static int s_health_heart_rate = -1;
+
+HealthServiceAccessibilityMask health_service_metric_accessible(HealthMetric metric, time_t start, time_t end) {
+  int value = metric == HealthMetricHeartRateBPM ? s_health_heart_rate : s_health_steps;
+  return value >= 0 ? HealthServiceAccessibilityMaskAvailable : 0;
+}
+
+HealthValue health_service_sum_today(HealthMetric metric) {
+  return metric == HealthMetricStepCount && s_health_steps > 0 ? s_health_steps : 0;
+}
+
+HealthValue health_service_peek_current_value(HealthMetric metric) {
+  return metric == HealthMetricHeartRateBPM && s_health_heart_rate > 0 ? s_health_heart_rate : 0;
+}
+
+bool health_service_events_subscribe(HealthEventHandler handler, void *context) {
+  s_health_handler = handler;
+  return true;
+}
+
+bool health_service_events_unsubscribe(void) {
+  s_health_handler = NULL;
+  return true;
+}
+
+void sim_set_health(int steps, int heart_rate) {
+  bool steps_changed = steps != s_health_steps;
+  bool heart_rate_changed = heart_rate != s_health_heart_rate;
+  s_health_steps = steps;
+  s_health_heart_rate = heart_rate;
+  if (s_health_handler && steps_changed) {
+    s_health_handler(HealthEventMovementUpdate, NULL);
+  }
+  if (s_health_handler && heart_rate_changed) {
+    s_health_handler(HealthEventHeartRateUpdate, NULL);
+  }
+  sim_render();
+}
+
+static UnobstructedAreaHandlers s_unobstructed_handlers;
+
+void unobstructed_area_service_subscribe(UnobstructedAreaHandlers handlers, void *context) {
+  s_unobstructed_handlers = handlers;
+}
+
+void unobstructed_area_service_unsubscribe(void) {
+  memset(&s_unobstructed_handlers, 0, sizeof(s_unobstructed_handlers));
+}
+
+void sim_set_unobstructed_height(int16_t height) {
+  s_obstruction = height;
+  if (s_unobstructed_handlers.did_change) {
+    s_unobstructed_handlers.did_change(NULL);
+  }
+  sim_render();
+}
+
+void vibes_short_pulse(void) {}
+
+// The driver owns the event loop (sim_run_for)
+void app_event_loop(void) {}
@@ -0,0 +1,122 @@
+// =============================================================================
+// HOST SIMULATION: day driver
+// =============================================================================
+// Loads the watchface against the fake SDK and plays a scripted day: minute
+// ticks, phone request/response rounds, local health updates, a button press,
+// a Bluetooth drop and a settings push. Prints the work done per simulated
+// hour so regressions in redraw or storage churn show up as numbers.
+//
+//   build/sim [hours] [-v]
+
+#define main watchface_main
+#include "../../src/c/oura-stats-watchface.c"
+#undef main
+
+#include "sim_phone.h"
+
+#define SIM_START_HOUR 6          // the day starts at 06:00 local (UTC)
+
+static int s_steps = 0;
+
+static time_t sim_start_time(void) {
+  struct tm tm = { .tm_year = 2026 - 1900, .tm_mon = 9, .tm_mday = 16, .tm_hour = SIM_START_HOUR };
+  return mktime(&tm);
+}
+
+// Steps every five minutes while awake, heart rate drifting with them
+static void health_tick(void *data) {
+  time_t now = sim_now();
+  struct tm tm;
+  localtime_r(&now, &tm);
+  if (tm.tm_hour >= 7 && tm.tm_hour < 23) {
+    s_steps += 40 + (tm.tm_min % 3) * 25;
+  }
+  sim_set_health(s_steps, 58 + (tm.tm_min / 5) % 7);
+  sim_schedule(5 * 60 * 1000, health_tick, NULL);
+}
+
+static void push_show_seconds(bool on) {
+  sim_dict_begin();
+  sim_dict_add_int(MESSAGE_KEY_show_seconds, on ? 1 : 0);
+  sim_inbox_deliver();
+}
+
+// Scripted events at the start of a simulated hour (0-based from SIM_START_HOUR)
+static void run_script(int hour) {
+  switch (hour) {
+    case 3:
+      sim_press_select();
+      break;
+    case 7:
+      sim_set_phone_connected(false);
+      break;
+    case 8:
+      sim_set_phone_connected(true);
+      break;
+    case 12:
+      push_show_seconds(true);
+      break;
+    case 13:
+      push_show_seconds(false);
+      break;
+    default:
+      break;
+  }
+}
+
+static void print_header(void) {
+  printf("%5s %8s %9s %8s %7s %7s %6s %8s %6s %8s %6s %4s %4s\n",
+         "hour", "set_text", "mk_dirty", "measure", "draws", "frames",
+         "p_wr", "p_bytes", "allocs", "a_bytes", "timers", "in", "out");
+}
+
+static void print_row(const char *label, const SimCounters *d) {
+  printf("%5s %8u %9u %8u %7u %7u %6u %8u %6u %8u %6u %4u %4u\n",
+         label, d->text_layer_set_text, d->layer_mark_dirty, d->text_measures,
+         d->text_draws, d->frames, d->persist_writes, d->persist_bytes,
+         d->allocs, d->bytes_allocated, d->timers, d->inbox_messages, d->outbox_sends);
+}
+
+int main(int argc, char **argv) {
+  int hours = 24;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-v") == 0) {
+      sim_set_log_level(APP_LOG_LEVEL_DEBUG);
+    } else {
+      hours = atoi(argv[i]) > 0 ? atoi(argv[i]) : hours;
+    }
+  }
+
+  setenv("TZ", "UTC", 1);
+  tzset();
+  sim_set_time(sim_start_time());
+  sim_phone_attach(2000);
+
+  SimCounters start = g_sim;
+  init();
+  sim_render();
+  SimCounters after_init = g_sim;
+  SimCounters d = sim_counters_diff(&start, &after_init);
+  print_header();
+  print_row("init", &d);
+
+  sim_schedule(60 * 1000, health_tick, NULL);
+  SimCounters total_start = g_sim;
+  for (int hour = 0; hour < hours; hour++) {
+    SimCounters before = g_sim;
+    run_script(hour);
+    sim_run_for(60 * 60 * 1000);
+    d = sim_counters_diff(&before, &g_sim);
+    char label[8];
+    snprintf(label, sizeof(label), "%02d", (SIM_START_HOUR + hour) % 24);
+    print_row(label, &d);
+  }
+  d = sim_counters_diff(&total_start, &g_sim);
+  print_row("total", &d);
+
+  size_t peak = sim_heap_peak();
+  deinit();
+  printf("\nphone requests: %u, heap peak: %zu bytes, heap after deinit: %zu bytes, log lines: %u\n",
+         sim_phone_requests(), peak, sim_heap_used(), g_sim.logs);
+  return 0;
+}
@@ -0,0 +1,89 @@
+// =============================================================================
+// HOST SIMULATION: driver hooks
+// =============================================================================
+// Control surface of pebble_fakes.c: simulated clock and event loop, scripted
+// inbox dictionaries, phone/health/button stimuli, and the counters the
+// reports are built from.
+
+#pragma once
+
+#include <pebble.h>
+
+// Work the watchface caused; reset or snapshot freely between phases
+typedef struct {
+  uint32_t text_layer_set_text;   // text_layer_set_text calls
+  uint32_t layer_mark_dirty;      // layer_mark_dirty calls (incl. implicit ones from setters)
+  uint32_t text_measures;         // graphics_text_layout_get_content_size / text_layer_get_content_size
+  uint32_t text_draws;            // graphics_draw_text plus text layers drawn by a frame
+  uint32_t frames;                // full redraws (something was dirty at the end of an event)
+  uint32_t layer_updates;         // update procs run by those frames
+  uint32_t persist_writes;
+  uint32_t persist_bytes;         // bytes handed to persist_write_*
+  uint32_t allocs;                // heap allocations (watchface malloc plus SDK objects)
+  uint32_t bytes_allocated;
+  uint32_t timers;                // app_timer_register calls
+  uint32_t inbox_messages;
+  uint32_t outbox_sends;
+  uint32_t logs;                  // APP_LOG lines
+} SimCounters;
+
+extern SimCounters g_sim;
+
+// Counter delta b - a, field by field
+SimCounters sim_counters_diff(const SimCounters *a, const SimCounters *b);
+
+// -----------------------------------------------------------------------------
+// Clock and event loop
+// -----------------------------------------------------------------------------
+
+void sim_set_time(time_t now);            // before init(); later time only moves via sim_run_for
+time_t sim_now(void);
+uint64_t sim_now_ms(void);
+
+// Advance simulated time, firing timers and tick events in order and drawing
+// a frame after every event that left something dirty
+void sim_run_for(uint32_t ms);
+// Draw one frame now if anything is dirty
+void sim_render(void);
+// Stop (or resume) tick events, e.g. to keep clock updates out of a measurement
+void sim_set_ticks_enabled(bool enabled);
+
+// Driver-side event (not an app timer: not counted, not on the app heap)
+typedef void (*SimEventFn)(void *data);
+void sim_schedule(uint32_t delay_ms, SimEventFn fn, void *data);
+
+// -----------------------------------------------------------------------------
+// AppMessage
+// -----------------------------------------------------------------------------
+
+// Build an inbox dictionary, then hand it to the registered inbox callback
+void sim_dict_begin(void);
+void sim_dict_add_int(uint32_t key, int32_t value);
+void sim_dict_add_uint8(uint32_t key, uint8_t value);
+void sim_dict_add_cstring(uint32_t key, const char *value);
+void sim_dict_add_bytes(uint32_t key, const uint8_t *data, uint16_t length);
+void sim_dict_add_tuple(uint32_t key, TupleType type, const void *data, uint16_t length);
+void sim_inbox_deliver(void);
+
+// Called with every message the watch sends, when the phone acknowledges it
+typedef void (*SimOutboxObserver)(DictionaryIterator *iter);
+void sim_set_outbox_observer(SimOutboxObserver observer);
+void sim_set_outbox_ack_ms(uint32_t ms);
+
+// -----------------------------------------------------------------------------
+// Stimuli
+// -----------------------------------------------------------------------------
+
+void sim_set_phone_connected(bool connected);
+void sim_set_health(int steps, int heart_rate);   // -1 = metric unavailable
+void sim_press_select(void);
+void sim_set_unobstructed_height(int16_t height); // 0 = no obstruction
+
+// -----------------------------------------------------------------------------
+// Heap and logging
+// -----------------------------------------------------------------------------
+
+size_t sim_heap_used(void);
+size_t sim_heap_peak(void);
+void sim_heap_reset_peak(void);
+void sim_set_log_level(int level);  // print APP_LOG lines at or below this level (0 = none)
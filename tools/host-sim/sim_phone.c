@@ -0,0 +1,101 @@
+// =============================================================================
+// HOST SIMULATION: phone side
+// =============================================================================
+
+#include "sim_phone.h"
+
+static SimMetrics s_metrics;
+static uint32_t s_latency_ms = 2000;
+static uint32_t s_requests = 0;
+static uint8_t s_pending_mask = 0;
+static int s_pending_stage = 0;
+
+void sim_metrics_default(SimMetrics *m) {
+  *m = (SimMetrics) {
+    .resting_heart_rate = 52, .hrv = 48, .readiness = 82, .temperature_centi = -12,
+    .recovery_index = 70, .sleep_score = 78, .sleep_minutes = 442, .deep_sleep_minutes = 81,
+    .activity_score = 74, .active_calories = 412, .steps = 8421,
+    .stress_seconds = 5400, .stress_high_seconds = 1800, .available = 0x1F
+  };
+}
+
+static void push_le(uint8_t *out, size_t *at, int64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    out[(*at)++] = (uint8_t)((uint64_t)value >> (8 * i));
+  }
+}
+
+size_t sim_encode_metrics_packet(uint8_t out[SIM_METRICS_PACKET_SIZE], const SimMetrics *m, uint8_t fetched_mask) {
+  time_t now = sim_now();
+  struct tm tm;
+  localtime_r(&now, &tm);
+  size_t at = 0;
+  out[at++] = 2;
+  out[at++] = m->available;
+  push_le(out, &at, (tm.tm_year + 1900) * 10000 + (tm.tm_mon + 1) * 100 + tm.tm_mday, 4);
+  push_le(out, &at, m->resting_heart_rate, 2);
+  push_le(out, &at, m->hrv, 2);
+  push_le(out, &at, m->readiness, 2);
+  push_le(out, &at, m->temperature_centi, 2);
+  push_le(out, &at, m->recovery_index, 2);
+  push_le(out, &at, m->sleep_score, 2);
+  push_le(out, &at, m->sleep_minutes, 2);
+  push_le(out, &at, m->deep_sleep_minutes, 2);
+  push_le(out, &at, m->activity_score, 2);
+  push_le(out, &at, m->active_calories, 2);
+  push_le(out, &at, m->steps, 4);
+  push_le(out, &at, m->stress_seconds, 4);
+  push_le(out, &at, m->stress_high_seconds, 4);
+  push_le(out, &at, now, 4);
+  out[at++] = fetched_mask;
+  out[at++] = 0;  // every simulated record is from the data date
+  return at;
+}
+
+void sim_phone_add_data_settings(void) {
+  sim_dict_add_int(MESSAGE_KEY_layout_left, 0);
+  sim_dict_add_int(MESSAGE_KEY_layout_middle, 1);
+  sim_dict_add_int(MESSAGE_KEY_layout_right, 2);
+  sim_dict_add_int(MESSAGE_KEY_date_format, 0);
+  sim_dict_add_int(MESSAGE_KEY_theme_mode, 0);
+  sim_dict_add_int(MESSAGE_KEY_show_loading, 0);
+}
+
+// fetchAllOuraData(): a status line per fetcher, then the aggregated payload
+static void phone_respond(void *data) {
+  if (s_pending_stage < 2) {
+    static const char *const k_status[] = { "Fetching Oura data...", "Processing metrics..." };
+    sim_dict_begin();
+    sim_dict_add_cstring(MESSAGE_KEY_debug_status, k_status[s_pending_stage++]);
+    sim_inbox_deliver();
+    sim_schedule(s_latency_ms / 2, phone_respond, NULL);
+    return;
+  }
+  uint8_t packet[SIM_METRICS_PACKET_SIZE];
+  size_t length = sim_encode_metrics_packet(packet, &s_metrics, s_pending_mask);
+  sim_dict_begin();
+  sim_phone_add_data_settings();
+  sim_dict_add_bytes(MESSAGE_KEY_metrics_packet, packet, (uint16_t)length);
+  sim_dict_add_int(MESSAGE_KEY_payload_complete, 1);
+  sim_inbox_deliver();
+}
+
+static void phone_outbox_observer(DictionaryIterator *iter) {
+  if (!dict_find(iter, MESSAGE_KEY_request_data)) {
+    return;
+  }
+  Tuple *mask = dict_find(iter, MESSAGE_KEY_stale_mask);
+  s_requests++;
+  s_pending_mask = mask ? (uint8_t)mask->value->uint8 : 0x1F;
+  s_pending_stage = 0;
+  sim_schedule(s_latency_ms / 2, phone_respond, NULL);
+}
+
+void sim_phone_attach(uint32_t latency_ms) {
+  sim_metrics_default(&s_metrics);
+  s_latency_ms = latency_ms;
+  sim_set_outbox_observer(phone_outbox_observer);
+}
+
+SimMetrics *sim_phone_metrics(void) { return &s_metrics; }
+uint32_t sim_phone_requests(void) { return s_requests; }
@@ -0,0 +1,42 @@
+// =============================================================================
+// HOST SIMULATION: phone side
+// =============================================================================
+// Builds the dictionaries src/pkjs/index.js sends, and answers request_data
+// the way the JS side does (debug status lines, then one data payload).
+
+#pragma once
+
+#include "sim.h"
+
+// One day of Oura values, in the units the metrics packet carries
+typedef struct {
+  int resting_heart_rate;
+  int hrv;
+  int readiness;
+  int temperature_centi;      // hundredths of a degree C
+  int recovery_index;
+  int sleep_score;
+  int sleep_minutes;
+  int deep_sleep_minutes;
+  int activity_score;
+  int active_calories;
+  int32_t steps;
+  int32_t stress_seconds;
+  int32_t stress_high_seconds;
+  uint8_t available;          // METRIC_BIT_* with data
+} SimMetrics;
+
+#define SIM_METRICS_PACKET_SIZE 44
+
+void sim_metrics_default(SimMetrics *m);
+
+// encodeMetricsPacket(): v2 packet stamped with the simulated date and time
+size_t sim_encode_metrics_packet(uint8_t out[SIM_METRICS_PACKET_SIZE], const SimMetrics *m, uint8_t fetched_mask);
+
+// The settings sendDataToWatch() attaches to every data payload
+void sim_phone_add_data_settings(void);
+
+// Install the outbox observer that answers request_data after `latency_ms`
+void sim_phone_attach(uint32_t latency_ms);
+SimMetrics *sim_phone_metrics(void);
+uint32_t sim_phone_requests(void);